@@ -27,9 +27,59 @@
 
 #include <iostream>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
+// Parameters read by the models. Each entry gets a dense index, so models
+// read their constants from a flat block instead of a string-keyed map.
+#define ECOMERISTEM_PARAMETERS(X) \
+    X(BeginDate) X(EndDate) X(ETPmax) X(Epsib) \
+    X(FSLA) X(G_L) X(Ict) X(Kcpot) \
+    X(Kdf) X(Ke_init) X(Kresp) X(Kresp_internode) \
+    X(LL_BL_init) X(Lef1) X(MGR_init) X(REW) \
+    X(RU1) X(Rolling_A) X(Rolling_B) X(SLAp) \
+    X(TEW) X(Tb) X(Tresp) X(WLR) \
+    X(allo_area) X(coef_MGR_PI) X(coef_ligulo_PI) X(coef_lin_IN_diam) \
+    X(coef_phyllo_PI) X(coef_plasto_PI) X(coeff1_R_d) X(coeff2_R_d) \
+    X(coeff_PI_lag) X(coeff_active_storage_IN) X(coeff_evaplayer) X(coeff_in_diam) \
+    X(coeff_lifespan) X(coeff_remob) X(coeff_sen) X(density) \
+    X(density_IN1) X(density_IN2) X(gdw) X(grain_filling_rate) \
+    X(intercmodel) X(internode_FW_DW) X(leaf_FW_DW) X(leaf_length_to_IN_length) \
+    X(leaf_stock_max) X(ligulo_init) X(maximumReserveInInternode) X(maxleaves) \
+    X(mu) X(nb_leaf_enabling_tillering) X(nb_leaf_indiv) X(nb_leaf_param2) \
+    X(nb_leaf_stem_elong) X(nb_leaf_tiller_pi) X(nbinitleaves) X(peduncle_diam) \
+    X(pf) X(phenostage_PRE_FLO_to_FLO) X(phenostage_to_end_filling) X(phenostage_to_maturity) \
+    X(phyllo_init) X(plasto_init) X(power_for_cstr) X(psib) \
+    X(ratio_INPed) X(realocationCoeff) X(resp_LER) X(resp_R_d) \
+    X(slope_LL_BL_at_PI) X(slope_length_IN) X(spike_creation_rate) X(stressBP) \
+    X(stressBP2) X(swc_init) X(thresAssim) X(thresINER) \
+    X(thresLEN) X(thresLER) X(thresTransp) X(wbmodel)
+
+namespace parameter {
+#define ECOMERISTEM_PARAMETER_ID(name) name,
+#define ECOMERISTEM_PARAMETER_NAME(name) #name,
+enum names { ECOMERISTEM_PARAMETERS(ECOMERISTEM_PARAMETER_ID) PARAMETERS_NB };
+
+inline const char * name(unsigned int id)
+{
+   static const char * const labels[PARAMETERS_NB] = {
+      ECOMERISTEM_PARAMETERS(ECOMERISTEM_PARAMETER_NAME)
+   };
+   return labels[id];
+}
+#undef ECOMERISTEM_PARAMETER_ID
+#undef ECOMERISTEM_PARAMETER_NAME
+
+inline int id(const std::string &paramName)
+{
+   for( unsigned int i = 0; i < PARAMETERS_NB; ++i )
+      if( paramName == name(i) )
+         return i;
+   return -1;
+}
+}
+
 namespace ecomeristem {
 struct Climate {
    double Temperature;
@@ -48,7 +98,10 @@ struct Climate {
 class ModelParameters {
  public:
    ModelParameters()
-   { }
+   {
+      for( unsigned int i = 0; i < parameter::PARAMETERS_NB; ++i )
+         mValues[i] = 0;
+   }
 
    virtual ~ModelParameters()
    { }
@@ -65,20 +118,68 @@ class ModelParameters {
       return ( it == mParams.end() ) ? 0 : it->second;
    }
 
+   double get( parameter::names id ) const
+   {
+      return mValues[id];
+   }
+
    Climate get( double time ) const
    {
-      return meteoValues[time-beginDate];
+      return meteo()[time-beginDate];
+   }
+
+   // meteoValues when filled, the shared meteo otherwise
+   const std::vector < Climate > &meteo() const
+   {
+      return meteoValues.empty() && mSharedMeteo ? *mSharedMeteo : meteoValues;
+   }
+
+   // The shared meteo when in use, null otherwise
+   std::shared_ptr < const std::vector < Climate > > getSharedMeteo() const
+   {
+      return meteoValues.empty() ? mSharedMeteo : nullptr;
+   }
+
+   // Moves meteoValues to an immutable vector shared by the copies of
+   // these parameters; filling meteoValues again overrides it. Does
+   // nothing when meteoValues is empty.
+   void shareMeteo()
+   {
+      if( meteoValues.empty() )
+         return;
+      mSharedMeteo = std::make_shared < const std::vector < Climate > >( std::move( meteoValues ) );
+      meteoValues.clear();
    }
 
 
    inline void set( const std::string &key, const double &value )
    {
       mParams[key] = value;
+      int id = parameter::id( key );
+      if( id >= 0 )
+         mValues[id] = value;
+   }
+
+   // Fills the dense block from mParams; call it once the raw parameters
+   // are loaded. Missing keys are reported here rather than at each read.
+   void resolve()
+   {
+      for( unsigned int i = 0; i < parameter::PARAMETERS_NB; ++i ) {
+         std::map < std::string, double >::const_iterator it;
+         it = mParams.find( parameter::name( i ) );
+
+         if( it == mParams.end() )
+            std::cout << "Warning: no value for " << parameter::name( i ) << std::endl;
+
+         mValues[i] = ( it == mParams.end() ) ? 0 : it->second;
+      }
    }
 
    inline void clear()
    {
       mParams.clear();
+      for( unsigned int i = 0; i < parameter::PARAMETERS_NB; ++i )
+         mValues[i] = 0;
    }
 
    
@@ -86,8 +187,13 @@ class ModelParameters {
    std::map < std::string, double > mParams;//!< Represent the parameters.
 public:
     std::map < std::string, double > * getRawParameters() { return &mParams; }
+    const std::map < std::string, double > * getRawParameters() const { return &mParams; }
     std::vector < Climate > * getMeteoValues() { return &meteoValues; }
     double beginDate;
+
+private:
+    double mValues[parameter::PARAMETERS_NB];
+    std::shared_ptr < const std::vector < Climate > > mSharedMeteo;
 };
 
 }
@@ -0,0 +1,115 @@
+#ifndef SIMPLEARENA_H
+#define SIMPLEARENA_H
+
+#include <vector>
+#include <new>
+#include <utility>
+#include <atomic>
+#include <mutex>
+using namespace std;
+
+//Simulation scoped storage for the models created while running (culms,
+//phytomers, organs). Objects of a same type are packed in fixed size chunks;
+//release() destroys them all at once and keeps the chunks for the next run.
+//create() may be called from the threads computing the culms of a plant,
+//and again from the constructors it runs.
+class SimpleArena {
+private:
+    class AbstractPool {
+    public:
+        virtual ~AbstractPool() {}
+        virtual void release() = 0;
+    };
+
+    template < typename T >
+    class Pool : public AbstractPool {
+    public:
+        static const size_t CHUNK_SIZE = 32;
+
+        Pool() : _size(0) {}
+        ~Pool() {
+            release();
+            for (T * chunk : _chunks)
+                ::operator delete(chunk);
+        }
+
+        template < typename... Args >
+        T * create(unsigned long & allocations, Args&&... args) {
+            if (_size == _chunks.size() * CHUNK_SIZE) {
+                _chunks.push_back(static_cast<T*>(::operator new(CHUNK_SIZE * sizeof(T))));
+                ++allocations;
+            }
+            T * object = new (_chunks[_size / CHUNK_SIZE] + _size % CHUNK_SIZE) T(std::forward<Args>(args)...);
+            ++_size;
+            return object;
+        }
+
+        void release() {
+            while (_size > 0) {
+                --_size;
+                (_chunks[_size / CHUNK_SIZE] + _size % CHUNK_SIZE)->~T();
+            }
+        }
+
+    private:
+        vector < T * > _chunks;
+        size_t _size;
+    };
+
+    static unsigned int next_type() {
+        static atomic < unsigned int > types(0);
+        return types++;
+    }
+
+    template < typename T >
+    static unsigned int type() {
+        static const unsigned int id = next_type();
+        return id;
+    }
+
+    template < typename T >
+    Pool<T> & pool() {
+        unsigned int id = type<T>();
+        if (_pools.size() <= id)
+            _pools.resize(id + 1, nullptr);
+        if (!_pools[id]) {
+            _pools[id] = new Pool<T>();
+            ++_allocations;
+        }
+        return *static_cast<Pool<T>*>(_pools[id]);
+    }
+
+    vector < AbstractPool * > _pools;
+    unsigned long _allocations;
+    unsigned long _objects;
+    recursive_mutex _mutex;
+
+public:
+    SimpleArena() : _allocations(0), _objects(0) {}
+    SimpleArena(const SimpleArena&) = delete;
+    SimpleArena& operator=(const SimpleArena&) = delete;
+    ~SimpleArena() {
+        for (AbstractPool * p : _pools)
+            delete p;
+    }
+
+    template < typename T, typename... Args >
+    T * create(Args&&... args) {
+        lock_guard < recursive_mutex > lock(_mutex);
+        ++_objects;
+        return pool<T>().create(_allocations, std::forward<Args>(args)...);
+    }
+
+    void release() {
+        for (AbstractPool * p : _pools)
+            if (p) p->release();
+        _objects = 0;
+    }
+
+    //heap allocations made by the arena since its creation
+    unsigned long allocations() const { return _allocations; }
+    //objects currently held
+    unsigned long objects() const { return _objects; }
+};
+
+#endif // SIMPLEARENA_H
@@ -0,0 +1,27 @@
+#ifndef SIMPLEFLOAT_H
+#define SIMPLEFLOAT_H
+
+#include <cstdint>
+#include <cstring>
+using namespace std;
+
+//NaN test that survives -ffinite-math-only (part of the -Ofast of Makevars),
+//under which std::isnan is folded to false: a NaN has all its exponent bits
+//set and a non-zero mantissa
+inline bool is_na(double x)
+{
+    uint64_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    return (bits & 0x7fffffffffffffffULL) > 0x7ff0000000000000ULL;
+}
+
+//same for infinities, std::isinf and std::isfinite being folded too: all
+//the exponent bits set and a zero mantissa
+inline bool is_inf(double x)
+{
+    uint64_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    return (bits & 0x7fffffffffffffffULL) == 0x7ff0000000000000ULL;
+}
+
+#endif // SIMPLEFLOAT_H
@@ -2,14 +2,18 @@
 #define SIMPLEMODEL_H
 
 #include <vector>
+#include <cmath>
 #include <iterator>
 #include <list>
 #include <memory>
 #include <algorithm>
 #include <mutex>
+#include <functional>
 #include <ModelParameters.hpp>
 
+#include <artis_lite/simplefloat.h>
 #include <artis_lite/simpletrace.h>
+#include <artis_lite/simplearena.h>
 
 using namespace std;
 
@@ -24,49 +28,150 @@ public:
     virtual void compute(double t, bool update = false) = 0;
     virtual void init(double t, const ecomeristem::ModelParameters& parameters) = 0;
     virtual const double getVal(unsigned int i) = 0;
+    //typed read of variable i, found once and called directly afterwards
+    typedef double (*Getter)(const AbstractSimpleModel *, unsigned int);
+    virtual Getter getter(unsigned int i) const = 0;
+
+    //model holding the variable of a selector chain: the first submodel of
+    //each index but the last one, which is the variable; null if missing
+    AbstractSimpleModel * find(const vector < unsigned int >& chain) {
+        AbstractSimpleModel * model = this;
+        for (size_t i = 0; i + 1 < chain.size() and model; ++i) {
+            unsigned int idx = chain[i];
+            model = idx < model->subModels.size() and !model->subModels[idx].empty() ?
+                        model->subModels[idx][0] : nullptr;
+        }
+        return model;
+    }
 };
 
 class SimpleView {
+public:
+    typedef std::vector < std::pair < double, double > > Value;
+    typedef map < string, Value > Values; //var, <day,val>
+
 private:
     typedef std::map < std::string, vector < unsigned int > > Selectors;
-    AbstractSimpleModel * _model;
+
+    //a selector compiled at attach time: the variable recorded in the
+    //column and, once found, the model holding it and its getter
+    struct Column {
+        string name;
+        vector < unsigned int > chain;
+        AbstractSimpleModel * model;
+        AbstractSimpleModel::Getter getter;
+    };
+
+    AbstractSimpleModel * _model = nullptr;
     double _begin = -1;
+    vector < string > _recorded;
+    vector < Column > _columns;
+    //results: the observed days and, column-major, _capacity values per
+    //column; days a variable could not be read stay NaN
+    vector < double > _days;
+    vector < double > _data;
+    size_t _capacity = 0;
+
+    static string lower(string n) {
+        std::transform(n.begin(), n.end(), n.begin(), ::tolower);
+        return n;
+    }
+
+    void compile() {
+        _columns.clear();
+        for (typename Selectors::const_iterator it = _selectors.begin(); it != _selectors.end(); ++it) {
+            if (_recorded.empty() or
+                    std::find(_recorded.begin(), _recorded.end(), it->first) != _recorded.end()) {
+                Column c = { it->first, it->second, nullptr, nullptr };
+                _columns.push_back(c);
+            }
+        }
+        _begin = -1;
+        _days.clear();
+        _data.assign(_capacity * _columns.size(), nan(""));
+    }
+
+    void grow(size_t capacity) {
+        vector < double > data(capacity * _columns.size(), nan(""));
+        for (size_t k = 0; k < _columns.size(); ++k)
+            std::copy(_data.begin() + k * _capacity, _data.begin() + k * _capacity + _days.size(),
+                      data.begin() + k * capacity);
+        _data.swap(data);
+        _capacity = capacity;
+    }
+
+    //submodels (culms...) may only exist once the model is initialized:
+    //a column is resolved on the first day its model is there
+    bool resolve(Column & c) {
+        AbstractSimpleModel * model = _model->find(c.chain);
+        if (!model)
+            return false;
+        c.model = model;
+        c.getter = model->getter(c.chain.back());
+        return true;
+    }
+
 public:
     Selectors _selectors;
-    typedef std::vector < std::pair < double, double > > Value;
-    typedef map < string, Value > Values; //var, <day,val>
-    Values _values;
 
     void selector(const string& name, artis::kernel::ValueTypeID /*type*/, const vector < unsigned int >& chain)  {
-		string n = name;
-		std::transform(n.begin(), n.end(), n.begin(), ::tolower);
-        _selectors[n] = chain;
-        _values[n] = vector < pair < double, double > >(0);
+        _selectors[lower(name)] = chain;
+    }
+
+    //only record these variables, an empty list records all of them
+    void record(const vector < string >& names) {
+        _recorded.clear();
+        for (const string& n : names)
+            _recorded.push_back(lower(n));
+        if (_model)
+            compile();
+    }
+
+    //makes room for the days of [begin, end] before a run
+    void reserve(double begin, double end) {
+        size_t days = end >= begin ? static_cast<size_t>(end - begin) + 1 : 0;
+        if (_days.size() + days > _capacity)
+            grow(_days.size() + days);
+    }
+
+    size_t columns() const { return _columns.size(); }
+    const string& name(size_t k) const { return _columns[k].name; }
+    //values of column k, one per observed day
+    const double * column(size_t k) const { return _data.data() + k * _capacity; }
+    const vector < double >& days() const { return _days; }
+    size_t size() const { return _days.size(); }
+
+    Values values() const {
+        Values values;
+        for (size_t k = 0; k < _columns.size(); ++k) {
+            Value & v = values[_columns[k].name];
+            for (size_t d = 0; d < _days.size(); ++d)
+                v.push_back(std::make_pair(_days[d], column(k)[d]));
+        }
+        return values;
     }
 
-    Values values() {return _values;}
-    void attachModel(AbstractSimpleModel * m) { _model = m; _begin = -1; _values = Values();}
-    double get(double t, string name) { return _values[name][t-_begin].second; }
-    double begin() {return _begin;}
-    double end() {return _values.begin()->second.back().first;}
+    void attachModel(AbstractSimpleModel * m) { _model = m; compile(); }
+    double get(double t, string name) const {
+        for (size_t k = 0; k < _columns.size(); ++k)
+            if (_columns[k].name == name)
+                return column(k)[static_cast<size_t>(t - _begin)];
+        return nan("");
+    }
+    double begin() const {return _begin;}
+    double end() const {return _days.empty() ? -1 : _days.back();}
 
     void observe(double time) {
         if(_begin < 0)
             _begin = time;
-        for (typename Selectors::const_iterator it = _selectors.begin(); it != _selectors.end(); ++it) {
-            AbstractSimpleModel * model = _model;
-            if (it->second.size() > 1) {
-                size_t i = 0;
-                while (i < it->second.size() - 1 and model) {
-                    model = model->subModels[it->second[i]][0];
-                    ++i;
-                }
-            }
-
-            if (model) {
-                double val = model->getVal(it->second.back());
-                _values[it->first].push_back(std::make_pair(time, val));
-            }
+        size_t day = _days.size();
+        if (day == _capacity)
+            grow(std::max<size_t>(2 * _capacity, 1));
+        _days.push_back(time);
+        for (size_t k = 0; k < _columns.size(); ++k) {
+            Column & c = _columns[k];
+            if (c.model or resolve(c))
+                _data[k * _capacity + day] = c.getter(c.model, c.chain.back());
         }
     }
 };
@@ -77,46 +182,79 @@ private:
     AbstractSimpleModel * _model;
 public:
     typedef std::map < std::string, SimpleView* > Views;
-    SimpleObserver(AbstractSimpleModel * model): _model(model){}
+    SimpleObserver(AbstractSimpleModel * model): v(nullptr), _model(model){}
     ~SimpleObserver(){}
     std::map < std::string, SimpleView * > views() const {
         return std::map < std::string, SimpleView * > {{"view",v}};
     }
-    void observe(double t){ v->observe(t); }
+    void reserve(double begin, double end){ if(v) v->reserve(begin, end); }
+    void observe(double t){ if(v) v->observe(t); }
     void attachView(const std::string& /*name*/, SimpleView * view) {
         v = view;
         v->attachModel(_model);
     }
 };
 
+//Sampling plan of runOptim, compiled from the observations: the steps to
+//sample in increasing order, each with the (variable, row) cells to fill.
+//NaN observations and rows without a valid day are left out of the plan.
 class SimulatorFilter {
 public:
-    vector < vector < vector <unsigned int> > > selector;
+    struct Sample {
+        unsigned int variable;
+        unsigned int row;
+    };
+
+    struct Step {
+        int step;
+        //rows observed up to this step included
+        size_t rows;
+        vector < Sample > samples;
+    };
+
     vector < double > days;
     vector < string > names;
+    //selector path of each variable
+    vector < vector < unsigned int > > chains;
+    //values of the result columns before the run: NaN for the skipped cells
+    vector < vector < double > > columns;
+    vector < Step > steps;
+
     void SimulatorFiler(){}
 
-    void init(SimpleView * view, map <string, vector<double> > filter, string dayColName) {
-        int idx = 0;
-        for(auto token: filter) {
-            string name = token.first;
-            vector <double> vals = token.second;
+    void init(SimpleView * view, const map <string, vector<double> >& filter, const string& dayColName) {
+        vector < const vector < double > * > observations;
+        for(auto const& token: filter) {
+            const string& name = token.first;
+            auto selector = view->_selectors.find(name);
             if(name == dayColName) {
-                days = vals;
-            } else {
-				if (view->_selectors.find(name) != view->_selectors.end()) {
-					names.push_back(name);
-					vector<vector <unsigned int> > s;
-					for (double v : vals) {
-						if (v != v)
-							s.push_back(vector<unsigned int>(0));
-						else
-							s.push_back(view->_selectors[name]);
-					}
-					selector.push_back(s);
-				}
+                days = token.second;
+            } else if (selector != view->_selectors.end()) {
+                names.push_back(name);
+                chains.push_back(selector->second);
+                observations.push_back(&token.second);
+            }
+        }
+
+        map < int, vector < Sample > > plan;
+        for (unsigned int i = 0; i < names.size(); ++i) {
+            columns.push_back(vector < double >(days.size()));
+            for (unsigned int row = 0; row < days.size(); ++row) {
+                double v = row < observations[i]->size() ? (*observations[i])[row] : nan("");
+                if (is_na(v)) {
+                    columns[i][row] = nan("");
+                } else if (days[row] >= 0 and days[row] == std::floor(days[row])) {
+                    Sample sample = { i, row };
+                    plan[static_cast<int>(days[row])].push_back(sample);
+                }
             }
-            idx++;
+        }
+        for (auto& token: plan) {
+            Step step = { token.first, 0, token.second };
+            for (double d : days)
+                if (d <= token.first)
+                    ++step.rows;
+            steps.push_back(step);
         }
     }
 };
@@ -137,33 +275,37 @@ class SimpleSimulator {
 private:
     T * _model;
     SimpleObserver _observer;
+    SimpleArena _arena;
 public:
-    SimpleSimulator(T * model, U parameters) : _model(model), _observer(model) {}
+    SimpleSimulator(T * model, U parameters) : _model(model), _observer(model) { _model->setArena(&_arena); }
     ~SimpleSimulator() {delete _model;}
-    void init(double time, const V& parameters) { _model->init(time, parameters); }
+    const SimpleArena& arena() const { return _arena; }
+    T * model() const { return _model; }
+    //models keep a pointer on parameters: they must outlive the simulator
+    //init can be called again to restart from scratch, the organs of the
+    //previous run are released and their storage reused
+    void init(double time, const V& parameters) {
+        _model->reset();
+        _arena.release();
+        _model->init(time, parameters);
+    }
     void attachView(const string& name, SimpleView * view){ _observer.attachView(name, view);}
     const SimpleObserver& observer() const { return _observer; }
     void run(SimpleContext & context) {
+        _observer.reserve(context.begin(), context.end());
         for (double t = context.begin(); t <= context.end(); t++) {
             (*_model)(t);
             _observer.observe(t);
         }
     }
 	
-	double getVal(double idx, double step, SimulatorFilter * filter) {
-        AbstractSimpleModel * model = _model;
-        if (filter->selector[idx][step].size() > 1) {
-            size_t i = 0;
-            while (i < filter->selector[idx][step].size() - 1 and model) {
-                model = model->subModels[filter->selector[idx][step][i]][0];
-                ++i;
-            }
-        }
-
-        if (model && filter->selector[idx][step].size() > 0) {
-            return model->getVal(filter->selector[idx][step].back());
-        }
-        return nan("");
+    double getVal(const vector < unsigned int >& chain, AbstractSimpleModel::Getter & getter) {
+        AbstractSimpleModel * model = _model->find(chain);
+        if (!model)
+            return nan("");
+        if (!getter)
+            getter = model->getter(chain.back());
+        return getter(model, chain.back());
     }
 
 //    void display(map<string, vector<double>> map) {
@@ -179,21 +321,50 @@ public:
 //        }
 //    }
 
-    map<string,vector<double>> runOptim(SimpleContext & context, SimulatorFilter & filter) {
+    //asked after each observed day with the results and the number of
+    //observed days filled, returns true to abandon the run
+    typedef std::function < bool(const map<string,vector<double>>&, size_t) > Stop;
+
+    //the run ends with the last observed day unless to_end is set, for
+    //callers which need the final state of the model
+    map<string,vector<double>> runOptim(SimpleContext & context, SimulatorFilter & filter,
+                                        bool to_end = false) {
+        bool pruned;
+        return runOptim(context, filter, Stop(), pruned, to_end);
+    }
+
+    //the days left when stop abandons the run are NaN and pruned is set
+    map<string,vector<double>> runOptim(SimpleContext & context, SimulatorFilter & filter,
+                                        const Stop & stop, bool & pruned, bool to_end = false) {
         map<string,vector<double>> results;
-        for(string name: filter.names) {
-            results.insert(make_pair(name, vector<double>(filter.selector[0].size())));
+        vector<double*> columns;
+        for (size_t i = 0; i < filter.names.size(); ++i) {
+            columns.push_back(results.insert(make_pair(filter.names[i], filter.columns[i])).first->second.data());
         }
+        //getters are found on the first sample of each variable and kept
+        //here, so that concurrent runs can share the filter
+        vector<AbstractSimpleModel::Getter> getters(filter.names.size(), nullptr);
 
-        int selectorIdx = 0;
+        pruned = false;
+        size_t next = 0;
         int step = 0;
         for (double t = context.begin(); t <= context.end(); t++) {
+            if(!to_end && next >= filter.steps.size())
+                break;
             (*_model)(t);
-            if(selectorIdx < filter.days.size() && filter.days[selectorIdx] == step) {
-                for (int i = 0; i < filter.names.size(); ++i) {
-                    results[filter.names[i]][selectorIdx] = getVal(i, selectorIdx, &filter);
+            if(next < filter.steps.size() && filter.steps[next].step == step) {
+                const SimulatorFilter::Step & s = filter.steps[next];
+                for (const SimulatorFilter::Sample & sample : s.samples) {
+                    columns[sample.variable][sample.row] = getVal(filter.chains[sample.variable], getters[sample.variable]);
+                }
+                ++next;
+                if(stop && stop(results, s.rows)) {
+                    pruned = true;
+                    for (; next < filter.steps.size(); ++next)
+                        for (const SimulatorFilter::Sample & sample : filter.steps[next].samples)
+                            columns[sample.variable][sample.row] = nan("");
+                    break;
                 }
-                selectorIdx++;
             }
             step++;
         }
@@ -209,47 +380,54 @@ private:
     template<typename U>
     struct id { typedef U type; };
 
+    //variable bindings are shared by every instance of T: the model
+    //constructors fill them once, later instances find them set
+    struct Bindings {
+        static const unsigned int SIZE = 100;
+        double T::* i_double[SIZE];
+        int T::* i_int[SIZE];
+        bool T::* i_bool[SIZE];
+        flag T::* i_flag[SIZE];
+        double T::* e_double[SIZE];
+        int T::* e_int[SIZE];
+        bool T::* e_bool[SIZE];
+        flag T::* e_flag[SIZE];
+    };
+    static Bindings _bindings;
+
+    template < typename W >
+    static void bind(W T::* & slot, W T::* var) { if(slot != var) slot = var; }
+
 protected:
     double last_time;
-    vector<double T::*> i_double;
-    vector<int T::*> i_int;
-    vector<bool T::*> i_bool;
-    vector<flag T::*> i_flag;
-    vector<double T::*> e_double;
-    vector<int T::*> e_int;
-    vector<bool T::*> e_bool;
-    vector<flag T::*> e_flag;
 
 public:
-    SimpleModel() {
-        i_double = vector<double T::*>(100);
-        i_int = vector<int T::*>(100);
-        i_bool = vector<bool T::*>(100);
-        i_flag = vector<flag T::*>(100);
-        e_double = vector<double T::*>(100);
-        e_int = vector<int T::*>(100);
-        e_bool = vector<bool T::*>(100);
-        e_flag = vector<flag T::*>(100);
+    const double getVal (unsigned int i) {
+        if(i < Bindings::SIZE && _bindings.i_double[i] != nullptr) return get<double>(0,i);
+        else if(i < Bindings::SIZE && _bindings.i_int[i] != nullptr) return static_cast<double>(get<int>(0,i));
+        else if(i < Bindings::SIZE && _bindings.i_bool[i] != nullptr) return static_cast<double>(get<bool>(0,i));
+        else if(i < Bindings::SIZE && _bindings.i_flag[i] != nullptr) return static_cast<double>(get<flag>(0,i));
     }
 
-    const double getVal (unsigned int i) {
-        if(i_double.size() > i && i_double[i] != nullptr) return get<double>(0,i);
-        else if(i_int.size() > i && i_int[i] != nullptr) return static_cast<double>(get<int>(0,i));
-        else if(i_bool.size() > i && i_bool[i] != nullptr) return static_cast<double>(get<bool>(0,i));
-        else if(i_flag.size() > i && i_flag[i] != nullptr) return static_cast<double>(get<flag>(0,i));
+    Getter getter(unsigned int i) const {
+        if(i < Bindings::SIZE && _bindings.i_double[i] != nullptr) return &read<double>;
+        else if(i < Bindings::SIZE && _bindings.i_int[i] != nullptr) return &read<int>;
+        else if(i < Bindings::SIZE && _bindings.i_bool[i] != nullptr) return &read<bool>;
+        else if(i < Bindings::SIZE && _bindings.i_flag[i] != nullptr) return &read<flag>;
+        return &unbound;
     }
 
     virtual void operator()(double t) {this->compute(t);}
-    void internal_(unsigned int index, const string& /*n*/, double T::* var) {i_double[index] = var;}
-    void internal_(unsigned int index, const string& /*n*/, int T::* var) {i_int[index] = var;}
-    void internal_(unsigned int index, const string& /*n*/, bool T::* var) {i_bool[index] = var;}
-    void internal_(unsigned int index, const string& /*n*/, flag T::* var) {i_flag[index] = var;}
-    void external_(unsigned int index, const string& /*n*/, double T::* var) {e_double[index] = var;}
-    void external_(unsigned int index, const string& /*n*/, int T::* var) {e_int[index] = var;}
-    void external_(unsigned int index, const string& /*n*/, bool T::* var) {e_bool[index] = var;}
-    void external_(unsigned int index, const string& /*n*/, flag T::* var) {e_flag[index] = var;}
-    template < typename W > W get(double t, unsigned int index) { return _get(t, index, id<W>()); }
-    template < typename W, typename U > W get(double t, unsigned int index) {return get<W>(t,index);}
+    void internal_(unsigned int index, const char* /*n*/, double T::* var) {bind(_bindings.i_double[index], var);}
+    void internal_(unsigned int index, const char* /*n*/, int T::* var) {bind(_bindings.i_int[index], var);}
+    void internal_(unsigned int index, const char* /*n*/, bool T::* var) {bind(_bindings.i_bool[index], var);}
+    void internal_(unsigned int index, const char* /*n*/, flag T::* var) {bind(_bindings.i_flag[index], var);}
+    void external_(unsigned int index, const char* /*n*/, double T::* var) {bind(_bindings.e_double[index], var);}
+    void external_(unsigned int index, const char* /*n*/, int T::* var) {bind(_bindings.e_int[index], var);}
+    void external_(unsigned int index, const char* /*n*/, bool T::* var) {bind(_bindings.e_bool[index], var);}
+    void external_(unsigned int index, const char* /*n*/, flag T::* var) {bind(_bindings.e_flag[index], var);}
+    template < typename W > W get(double t, unsigned int index) const { return _get(t, index, id<W>()); }
+    template < typename W, typename U > W get(double t, unsigned int index) const {return get<W>(t,index);}
     template < typename W > void put(double t, unsigned int index, W value) {_put(t, index, value);}
     void subModel(unsigned int index, AbstractSimpleModel * model) { setsubmodel(index, model); }
 
@@ -261,19 +439,27 @@ public:
     }
 
 private:
-    double _get(double /*t*/, unsigned int index, id<double>){return static_cast<SimpleModel<T>*>(this)->*static_cast<double SimpleModel<T>::*>(i_double[index]);}
-    int _get(double /*t*/, unsigned int index, id<int>){return static_cast<SimpleModel<T>*>(this)->*static_cast<int SimpleModel<T>::*>(i_int[index]);}
-    bool _get(double /*t*/, unsigned int index, id<bool>){return static_cast<SimpleModel<T>*>(this)->*static_cast<bool SimpleModel<T>::*>(i_bool[index]);}
-    flag _get(double /*t*/, unsigned int index, id<flag>){return static_cast<SimpleModel<T>*>(this)->*static_cast<flag SimpleModel<T>::*>(i_flag[index]);}
-    void _put(double /*t*/, unsigned int index, double value) {static_cast<SimpleModel<T>*>(this)->*static_cast<double SimpleModel<T>::*>(e_double[index]) = value;}
-    void _put(double /*t*/, unsigned int index, int value) {static_cast<SimpleModel<T>*>(this)->*static_cast<int SimpleModel<T>::*>(e_int[index]) = value;}
-    void _put(double /*t*/, unsigned int index, bool value) {static_cast<SimpleModel<T>*>(this)->*static_cast<bool SimpleModel<T>::*>(e_bool[index]) = value;}
-    void _put(double /*t*/, unsigned int index, flag value) {static_cast<SimpleModel<T>*>(this)->*static_cast<flag SimpleModel<T>::*>(e_flag[index]) = value;}
+    template < typename W >
+    static double read(const AbstractSimpleModel * m, unsigned int index)
+    { return static_cast<double>(static_cast<const T*>(m)->template get<W>(0, index)); }
+    static double unbound(const AbstractSimpleModel * /*m*/, unsigned int /*index*/) { return nan(""); }
+
+    double _get(double /*t*/, unsigned int index, id<double>) const {return static_cast<const T*>(this)->*_bindings.i_double[index];}
+    int _get(double /*t*/, unsigned int index, id<int>) const {return static_cast<const T*>(this)->*_bindings.i_int[index];}
+    bool _get(double /*t*/, unsigned int index, id<bool>) const {return static_cast<const T*>(this)->*_bindings.i_bool[index];}
+    flag _get(double /*t*/, unsigned int index, id<flag>) const {return static_cast<const T*>(this)->*_bindings.i_flag[index];}
+    void _put(double /*t*/, unsigned int index, double value) {static_cast<T*>(this)->*_bindings.e_double[index] = value;}
+    void _put(double /*t*/, unsigned int index, int value) {static_cast<T*>(this)->*_bindings.e_int[index] = value;}
+    void _put(double /*t*/, unsigned int index, bool value) {static_cast<T*>(this)->*_bindings.e_bool[index] = value;}
+    void _put(double /*t*/, unsigned int index, flag value) {static_cast<T*>(this)->*_bindings.e_flag[index] = value;}
 };
 
+template < typename T >
+typename SimpleModel<T>::Bindings SimpleModel<T>::_bindings;
+
 #define DOUBLEESCAPE(a) #a
 #define ESCAPEQUOTE(a) DOUBLEESCAPE(a)
-#define Internal(index, var) internal_(index, string(ESCAPEQUOTE(index)), var)
-#define External(index, var) external_(index, string(ESCAPEQUOTE(index)), var)
+#define Internal(index, var) internal_(index, ESCAPEQUOTE(index), var)
+#define External(index, var) external_(index, ESCAPEQUOTE(index), var)
 
 #endif // SIMPLEMODEL_H
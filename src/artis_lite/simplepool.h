@@ -0,0 +1,95 @@
+#ifndef SIMPLEPOOL_H
+#define SIMPLEPOOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+using namespace std;
+
+//Worker threads kept for the parallel loops of a single simulation: run
+//spreads the indices of a loop over the workers and the calling thread and
+//returns once they are all done. The workers sleep between loops.
+class SimplePool {
+public:
+    //threads counts the calling thread
+    SimplePool(unsigned int threads) : _task(nullptr), _size(0), _next(0), _pending(0),
+        _generation(0), _stop(false) {
+        for (unsigned int i = 1; i < threads; ++i)
+            _workers.push_back(thread(&SimplePool::wait, this));
+    }
+
+    ~SimplePool() {
+        {
+            lock_guard < mutex > lock(_mutex);
+            _stop = true;
+        }
+        _wake.notify_all();
+        for (thread & t : _workers)
+            t.join();
+    }
+
+    SimplePool(const SimplePool&) = delete;
+    SimplePool& operator=(const SimplePool&) = delete;
+
+    unsigned int threads() const { return _workers.size() + 1; }
+
+    //calls task(i) for each i in [0, size), in no particular order
+    void run(size_t size, const function < void(size_t) > & task) {
+        if (_workers.empty() or size < 2) {
+            for (size_t i = 0; i < size; ++i)
+                task(i);
+            return;
+        }
+        {
+            lock_guard < mutex > lock(_mutex);
+            _task = &task;
+            _size = size;
+            _next = 0;
+            _pending = _workers.size();
+            ++_generation;
+        }
+        _wake.notify_all();
+        work();
+        unique_lock < mutex > lock(_mutex);
+        _done.wait(lock, [this]() { return _pending == 0; });
+        _task = nullptr;
+    }
+
+private:
+    void work() {
+        for (size_t i = _next++; i < _size; i = _next++)
+            (*_task)(i);
+    }
+
+    void wait() {
+        unsigned long generation = 0;
+        unique_lock < mutex > lock(_mutex);
+        for (;;) {
+            _wake.wait(lock, [&]() { return _stop or _generation != generation; });
+            if (_stop)
+                return;
+            generation = _generation;
+            lock.unlock();
+            work();
+            lock.lock();
+            if (--_pending == 0)
+                _done.notify_one();
+        }
+    }
+
+    vector < thread > _workers;
+    mutex _mutex;
+    condition_variable _wake;
+    condition_variable _done;
+    const function < void(size_t) > * _task;
+    size_t _size;
+    atomic < size_t > _next;
+    size_t _pending;
+    unsigned long _generation;
+    bool _stop;
+};
+
+#endif // SIMPLEPOOL_H
@@ -73,13 +73,16 @@ public:
                      LL_BL,IS_FIRST_DAY_PI, MS_PHYT_INDEX, MS_SHEATH_LLL, PREDIM_APP_LEAF_MS };
 
 
-    CulmModel(int index):
+    CulmModel(int index, SimpleArena & arena):
+        _arena(&arena),
+        _culm_stock_model(arena.create<CulmStockModelNG>()),
+        _culm_ictmodel(arena.create<IctModel>()),
+        _culm_thermaltime_model(arena.create<ThermalTimeModel>()),
+        _culm_thermaltime_modelNG(arena.create<ThermalTimeModelNG>()),
+        _panicle_model(nullptr),
+        _peduncle_model(nullptr),
         _index(index),
-        _is_first_culm(index == 1),
-        _culm_stock_model(new CulmStockModelNG),
-        _culm_thermaltime_model(new ThermalTimeModel),
-        _culm_ictmodel(new IctModel),
-        _culm_thermaltime_modelNG(new ThermalTimeModelNG)
+        _is_first_culm(index == 1)
     {
 
         Internal(NB_LIG, &CulmModel::_nb_lig);
@@ -182,20 +185,7 @@ public:
     }
 
     virtual ~CulmModel()
-    {
-        _culm_stock_model.reset(nullptr);
-        _culm_ictmodel.reset(nullptr);
-        _culm_thermaltime_modelNG.reset(nullptr);
-        _culm_thermaltime_model.reset(nullptr);
-        _panicle_model.reset(nullptr);
-        _peduncle_model.reset(nullptr);
-
-        auto it = _phytomer_models.begin();
-        while (it != _phytomer_models.end()) {
-            delete *it;
-            ++it;
-        }
-    }
+    { }
 
 
     bool is_phytomer_creatable() {
@@ -255,9 +245,9 @@ public:
             if( _plant_state & plant::NEW_PHYTOMER_AVAILABLE) {
                 if( _plant_phase == plant::PI) {
                     if(!_started_PI) {
-                        _panicle_model = std::unique_ptr<PanicleModel>(new PanicleModel());
-                        subModel(PANICLE, _panicle_model.get());
-                        _panicle_model->init(t, _parameters);
+                        _panicle_model = _arena->create<PanicleModel>();
+                        subModel(PANICLE, _panicle_model);
+                        _panicle_model->init(t, *_parameters);
                         _started_PI = true;
                     }
                 }
@@ -266,9 +256,9 @@ public:
                 if(_is_first_culm and _plant_phase == plant::PI) {
                     return;
                 }
-                _peduncle_model = std::unique_ptr<PeduncleModel>(new PeduncleModel(_index, _is_first_culm));
-                subModel(PEDUNCLE, _peduncle_model.get());
-                _peduncle_model->init(t, _parameters);
+                _peduncle_model = _arena->create<PeduncleModel>(_index, _is_first_culm);
+                subModel(PEDUNCLE, _peduncle_model);
+                _peduncle_model->init(t, *_parameters);
                 _culm_phase = culm::PRE_FLO;
                 _culm_phenostage_at_pre_flo = _culm_phenostage;
             }
@@ -462,7 +452,7 @@ public:
         _deleted_senesc_dw_sum = _deleted_senesc_dw_sum + _deleted_senesc_dw;
 
         auto it = _phytomer_models.begin();
-        std::deque < PhytomerModel* >::iterator previous_it;
+        std::vector < PhytomerModel* >::iterator previous_it;
         int i = 0;
         _nb_lig = 0;
         _nb_lig_tot = 0;
@@ -487,6 +477,9 @@ public:
         _senesc_dw_sum = 0;
         _first_leaf_tot_len = 0;
 
+        //phytomers are computed in order: a phytomer reads what the previous
+        //one produced the same day (leaf predim, sheath_LLL, internode predim
+        //and diameter), so this loop can't be batched across phytomers
         while (it != _phytomer_models.end()) {
             //Phytomers
             compute_phytomers(it, previous_it, i, t);
@@ -513,7 +506,7 @@ public:
         }
 
         //Floral_organs
-        if(_panicle_model.get()) {
+        if(_panicle_model) {
             _panicle_model->put (t, PanicleModel::DELTA_T, _delta_t);
             _panicle_model->put < plant::plant_phase >(t, PanicleModel::PLANT_PHASE, _plant_phase);
             _panicle_model->put(t, PanicleModel::FCSTR, _fcstr);
@@ -524,7 +517,7 @@ public:
             _grain_nb = _panicle_model->get < double >(t, PanicleModel::GRAIN_NB);
         }
 
-        if(_peduncle_model.get()) {
+        if(_peduncle_model) {
             _peduncle_model->put < plant::plant_phase >(t, PeduncleModel::PLANT_PHASE, _plant_phase);
             _peduncle_model->put < culm::culm_phase >(t, PeduncleModel::CULM_PHASE, _culm_phase);
             _peduncle_model->put (t, PeduncleModel::INTER_PREDIM, _peduncle_inerlen_predim);
@@ -540,7 +533,7 @@ public:
             (*_peduncle_model)(t);
         }
 
-        if(_peduncle_model.get()) {
+        if(_peduncle_model) {
             _peduncle_last_demand = _peduncle_model->get < double >(t, PeduncleModel::LAST_DEMAND);
             _peduncle_day_demand = _peduncle_model->get < double >(t, PeduncleModel::DEMAND);
             _peduncle_len = _peduncle_model->get < double >(t, PeduncleModel::LENGTH);
@@ -556,8 +549,8 @@ public:
         }
     }
 
-    void get_nonvegetative_in(std::deque < PhytomerModel* >::iterator it, double t) {
-        if(_peduncle_model.get()) {
+    void get_nonvegetative_in(std::vector < PhytomerModel* >::iterator it, double t) {
+        if(_peduncle_model) {
             if(((*it)->internode()->get < double >(t, InternodeModel::INTERNODE_LEN)) > 0) {
                 _peduncle_inerlen_predim = (*it)->internode()->get<double>(t, InternodeModel::INTERNODE_PREDIM);
                 _peduncle_inerdiam_predim = (*it)->internode()->get<double>(t, InternodeModel::INTER_DIAMETER);
@@ -615,7 +608,7 @@ public:
         (*_culm_thermaltime_modelNG)(t);
     }
 
-    void compute_phytomers(std::deque < PhytomerModel* >::iterator it, std::deque < PhytomerModel* >::iterator previous_it, int i, double t) {
+    void compute_phytomers(std::vector < PhytomerModel* >::iterator it, std::vector < PhytomerModel* >::iterator previous_it, int i, double t) {
         (*it)->put(t, PhytomerModel::DD, _culm_DD);
         (*it)->put(t, PhytomerModel::DELTA_T, _delta_t);
         (*it)->put(t, PhytomerModel::FTSW, _ftsw);
@@ -684,7 +677,7 @@ public:
         (**it)(t);
     }
 
-    void compute_vars(std::deque < PhytomerModel* >::iterator it, std::deque < PhytomerModel* >::iterator previous_it, int i, double t) {
+    void compute_vars(std::vector < PhytomerModel* >::iterator it, std::vector < PhytomerModel* >::iterator previous_it, int i, double t) {
         if((*it)->is_leaf_lig(t)) {
             _lig_index = i+1;
         }
@@ -776,7 +769,7 @@ public:
 
     void create_phytomer(double t)
     {
-        if (t != _parameters.beginDate) {
+        if (t != _parameters->beginDate) {
             int index;
             bool last_phytomer = true;
             if (_phytomer_models.empty()) {
@@ -792,9 +785,9 @@ public:
                 index = _phytomer_models.back()->get_index() + 1;
             }
 
-            PhytomerModel* phytomer = new PhytomerModel(index, _is_first_culm, _plasto, _phyllo, _ligulo, _LL_BL, last_phytomer);
+            PhytomerModel* phytomer = _arena->create<PhytomerModel>(index, _is_first_culm, _plasto, _phyllo, _ligulo, _LL_BL, last_phytomer);
             setsubmodel(PHYTOMERS, phytomer);
-            phytomer->init(t, _parameters);
+            phytomer->init(t, *_parameters);
             _phytomer_models.push_back(phytomer);
         }
     }
@@ -803,7 +796,7 @@ public:
     { return _phytomer_models.size(); }
 
     int get_app_phytomer_number(double t) const {
-        std::deque < PhytomerModel* >::const_iterator it = _phytomer_models.begin();
+        std::vector < PhytomerModel* >::const_iterator it = _phytomer_models.begin();
         int i = 0;
         while (it != _phytomer_models.end()) {
             if ((*it)->is_leaf_dead(t-1) or (*it)->is_leaf_lig(t-1) or (*it)->is_leaf_app(t-1)) {
@@ -818,7 +811,7 @@ public:
     { return _phytomer_models.size() - _deleted_leaf_number; }
 
     int get_dead_phytomer_number(double t) const {
-        std::deque < PhytomerModel* >::const_iterator it = _phytomer_models.begin();
+        std::vector < PhytomerModel* >::const_iterator it = _phytomer_models.begin();
         int i = 0;
         while (it != _phytomer_models.end()) {
             if ((*it)->is_leaf_dead(t)) {
@@ -857,7 +850,7 @@ public:
             }
 
             //kill leaves and internodes
-            std::deque < PhytomerModel* >::const_iterator it = _phytomer_models.begin();
+            std::vector < PhytomerModel* >::const_iterator it = _phytomer_models.begin();
             while(it != _phytomer_models.end()) {
                 (*it)->internode()->culm_dead(t);
                 (*it)->kill_leaf(t);
@@ -885,7 +878,7 @@ public:
 
     int  get_first_ligulated_leaf_index(double t) const
     {
-        std::deque < PhytomerModel* >::const_iterator it = _phytomer_models.begin();
+        std::vector < PhytomerModel* >::const_iterator it = _phytomer_models.begin();
         int i = 0;
         while (it != _phytomer_models.end()) {
             if (not (*it)->is_leaf_dead(t) and (*it)->is_leaf_lig(t)) {
@@ -903,7 +896,7 @@ public:
 
     int  get_first_alive_leaf_index(double t) const
     {
-        std::deque < PhytomerModel* >::const_iterator it = _phytomer_models.begin();
+        std::vector < PhytomerModel* >::const_iterator it = _phytomer_models.begin();
         int i = 0;
         int index = -1;
         while (it != _phytomer_models.end()) {
@@ -919,7 +912,7 @@ public:
 
     int  get_first_alive_leaf_index2(double t) const
     {
-        std::deque < PhytomerModel* >::const_iterator it = _phytomer_models.begin();
+        std::vector < PhytomerModel* >::const_iterator it = _phytomer_models.begin();
         int i = 0;
         int index = -1;
         while (it != _phytomer_models.end()) {
@@ -935,7 +928,7 @@ public:
 
     int  get_first_alive_leaf_creation_date(double t) const
     {
-        std::deque < PhytomerModel* >::const_iterator it = _phytomer_models.begin();
+        std::vector < PhytomerModel* >::const_iterator it = _phytomer_models.begin();
         double creation_date = -1;
         int i = 1;
         while (it != _phytomer_models.end()) {
@@ -950,19 +943,19 @@ public:
     }
 
     CulmStockModelNG * stock_model() const {
-        return _culm_stock_model.get();
+        return _culm_stock_model;
     }
 
     IctModel * ictmodel() const {
-        return _culm_ictmodel.get();
+        return _culm_ictmodel;
     }
 
     ThermalTimeModel * thermaltime_model() const {
-        return _culm_thermaltime_model.get();
+        return _culm_thermaltime_model;
     }
 
     ThermalTimeModelNG * thermaltime_modelNG() const {
-        return _culm_thermaltime_modelNG.get();
+        return _culm_thermaltime_modelNG;
     }
 
 
@@ -970,14 +963,14 @@ public:
         last_time = t-1;
         first_day = t;
 
-        _parameters = parameters;
-        _nb_leaf_param2 = _parameters.get("nb_leaf_param2");
-        _plasto_init = _parameters.get("plasto_init");
-        _phyllo_init = _parameters.get("phyllo_init");
-        _ligulo_init = _parameters.get("ligulo_init");
-        _coeff_Plasto_PI = _parameters.get("coef_plasto_PI");
-        _coeff_Phyllo_PI = _parameters.get("coef_phyllo_PI");
-        _coeff_Ligulo_PI = _parameters.get("coef_ligulo_PI");
+        _parameters = &parameters;
+        _nb_leaf_param2 = _parameters->get(parameter::nb_leaf_param2);
+        _plasto_init = _parameters->get(parameter::plasto_init);
+        _phyllo_init = _parameters->get(parameter::phyllo_init);
+        _ligulo_init = _parameters->get(parameter::ligulo_init);
+        _coeff_Plasto_PI = _parameters->get(parameter::coef_plasto_PI);
+        _coeff_Phyllo_PI = _parameters->get(parameter::coef_phyllo_PI);
+        _coeff_Ligulo_PI = _parameters->get(parameter::coef_ligulo_PI);
 
         if(_plant_phenostage >= _nb_leaf_param2) {
             _plasto = _plasto_init * _coeff_Plasto_PI;
@@ -988,14 +981,14 @@ public:
             _phyllo = _phyllo_init;
             _ligulo = _ligulo_init;
         }
-        PhytomerModel* first_phytomer = new PhytomerModel(1, _is_first_culm, _plasto, _phyllo, _ligulo, _LL_BL, false);
+        PhytomerModel* first_phytomer = _arena->create<PhytomerModel>(1, _is_first_culm, _plasto, _phyllo, _ligulo, _LL_BL, false);
         setsubmodel(PHYTOMERS, first_phytomer);
         first_phytomer->init(t, parameters);
         _phytomer_models.push_back(first_phytomer);
         if(_is_first_culm) {
-            PhytomerModel* second_phytomer = new PhytomerModel(2, _is_first_culm, _plasto, _phyllo, _ligulo, _LL_BL, false);
-            PhytomerModel* third_phytomer = new PhytomerModel(3, _is_first_culm, _plasto, _phyllo, _ligulo, _LL_BL, false);
-            PhytomerModel* fourth_phytomer = new PhytomerModel(4, _is_first_culm, _plasto, _phyllo, _ligulo, _LL_BL, false);
+            PhytomerModel* second_phytomer = _arena->create<PhytomerModel>(2, _is_first_culm, _plasto, _phyllo, _ligulo, _LL_BL, false);
+            PhytomerModel* third_phytomer = _arena->create<PhytomerModel>(3, _is_first_culm, _plasto, _phyllo, _ligulo, _LL_BL, false);
+            PhytomerModel* fourth_phytomer = _arena->create<PhytomerModel>(4, _is_first_culm, _plasto, _phyllo, _ligulo, _LL_BL, false);
 
             setsubmodel(PHYTOMERS, second_phytomer);
             second_phytomer->init(t, parameters);
@@ -1017,12 +1010,12 @@ public:
 
 
         //parameters
-        _phenostage_pre_flo_to_flo  = _parameters.get("phenostage_PRE_FLO_to_FLO");
-        _coeff_pi_lag = _parameters.get("coeff_PI_lag");
-        _realocationCoeff = _parameters.get("realocationCoeff");
-        _maxleaves = _parameters.get("maxleaves");
-        _nb_leaf_stem_elong = _parameters.get("nb_leaf_stem_elong");
-        _nb_leaf_tiller_pi = _parameters.get("nb_leaf_tiller_pi");
+        _phenostage_pre_flo_to_flo  = _parameters->get(parameter::phenostage_PRE_FLO_to_FLO);
+        _coeff_pi_lag = _parameters->get(parameter::coeff_PI_lag);
+        _realocationCoeff = _parameters->get(parameter::realocationCoeff);
+        _maxleaves = _parameters->get(parameter::maxleaves);
+        _nb_leaf_stem_elong = _parameters->get(parameter::nb_leaf_stem_elong);
+        _nb_leaf_tiller_pi = _parameters->get(parameter::nb_leaf_tiller_pi);
 
         //    internals
         _tt_plasto = _plasto_init;
@@ -1113,7 +1106,7 @@ public:
         _culm_maxleaves = 0;
         _grain_nb = 0;
         _deleted_senesc_dw_sum = 0;
-        _culm_nbleaf_stem_elong = _parameters.get("nb_leaf_stem_elong");
+        _culm_nbleaf_stem_elong = _parameters->get(parameter::nb_leaf_stem_elong);
         _in_diam_predim_ms = 0;
         _culm_survived = false;
         _leaf_senesc_index = -1;
@@ -1121,16 +1114,17 @@ public:
 
 
 private:
-    ecomeristem::ModelParameters _parameters;
+    const ecomeristem::ModelParameters * _parameters;
 
     //  submodels
-    std::unique_ptr < CulmStockModelNG > _culm_stock_model;
-    std::unique_ptr < IctModel > _culm_ictmodel;
-    std::unique_ptr < ThermalTimeModel > _culm_thermaltime_model;
-    std::unique_ptr < ThermalTimeModelNG > _culm_thermaltime_modelNG;
-    std::deque < PhytomerModel* > _phytomer_models;
-    std::unique_ptr < PanicleModel > _panicle_model;
-    std::unique_ptr < PeduncleModel > _peduncle_model;
+    SimpleArena * _arena;
+    CulmStockModelNG * _culm_stock_model;
+    IctModel * _culm_ictmodel;
+    ThermalTimeModel * _culm_thermaltime_model;
+    ThermalTimeModelNG * _culm_thermaltime_modelNG;
+    std::vector < PhytomerModel* > _phytomer_models;
+    PanicleModel * _panicle_model;
+    PeduncleModel * _peduncle_model;
 
     //    attributes
     double _index;
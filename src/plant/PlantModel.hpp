@@ -32,6 +32,7 @@
 #include <plant/processes/PlantStockModel.hpp>
 #include <plant/processes/AssimilationModel.hpp>
 #include <plant/processes/InterceptionModel.hpp>
+#include <artis_lite/simplepool.h>
 
 using namespace model;
 
@@ -63,6 +64,7 @@ public:
                      CREATED_TILLERS, CULM_DEFICIT_SUM, BIOMAERO, NBLEAFPLANT };
 
     PlantModel() :
+        _arena(nullptr),
         _water_balance_model(new WaterBalanceModel),
         _stock_model(new PlantStockModel),
         _assimilation_model(new AssimilationModel),
@@ -179,12 +181,44 @@ public:
         _stock_model.reset(nullptr);
         _assimilation_model.reset(nullptr);
         _interception_model.reset(nullptr);
+    }
 
-        auto it = _culm_models.begin();
-        while (it != _culm_models.end()) {
-            delete *it;
-            ++it;
-        }
+    // culms and their organs are allocated in the simulator arena
+    void setArena(SimpleArena * arena)
+    { _arena = arena; }
+
+    // culms of a step computed by n threads, the caller included; the sums
+    // over the culms are made in the same order whatever n
+    void setCulmThreads(unsigned int n)
+    {
+        if (n > 1)
+            bindModels();
+        _culm_pool.reset(n > 1 ? new SimplePool(n) : nullptr);
+    }
+
+    // the variable bindings of a model type are filled by its first
+    // instance: builds one of each so that threads creating organs later,
+    // panicles and peduncles included, only read them
+    static void bindModels()
+    {
+        static std::once_flag bound;
+        std::call_once(bound, []() {
+            SimpleArena arena;
+            PlantModel plant;
+            CulmModel culm(1, arena);
+            PhytomerModel phytomer(1, true, 0, 0, 0, 0, false);
+            PanicleModel panicle;
+            PeduncleModel peduncle(1, true);
+        });
+    }
+
+    // forgets the culms of a previous run before a new init, the
+    // simulator releases their storage in the arena
+    void reset()
+    {
+        _culm_models.clear();
+        if (subModels.size() > CULMS)
+            subModels[CULMS].clear();
     }
 
 
@@ -285,7 +319,7 @@ public:
 
     void compute(double t, bool /* update */) {
         //Delete culm and leaf
-        std::deque < CulmModel* >::const_iterator nc = _culm_models.begin();
+        std::vector < CulmModel* >::const_iterator nc = _culm_models.begin();
         while(nc != _culm_models.end()) {
             if((*nc)->get < bool, CulmModel >(t-1, CulmModel::KILL_CULM)) {
                 _deleted_leaf_biomass += (*nc)->get < double, CulmModel >(t-1, CulmModel::DEL_LEAF_BIOM);
@@ -307,7 +341,7 @@ public:
         _stock_model->compute_IC(t);
 
         //Thermal time
-        _Ta = _parameters.get(t).Temperature;
+        _Ta = _parameters->get(t).Temperature;
         _deltaT = _Ta - _Tb;
         //Thermal time New : TODO
         //if(_Ta < _Tb) {
@@ -323,12 +357,15 @@ public:
         _TT = _TT + _deltaT;
 
 
-        std::deque < CulmModel* >::const_iterator culms = _culm_models.begin();
+        //plant values are the same for every culm
+        double ic_plant = _stock_model->get <double> (t-1, PlantStockModel::IC);
+        bool indiv = _plant_state & plant::INDIV;
+        std::vector < CulmModel* >::const_iterator culms = _culm_models.begin();
         int i = 0;
         while(culms != _culm_models.end()) {
-            (*culms)->ictmodel()->put < double >(t, IctModel::IC_plant, _stock_model->get <double> (t-1, PlantStockModel::IC));
+            (*culms)->ictmodel()->put < double >(t, IctModel::IC_plant, ic_plant);
             (*culms)->compute_ictmodel(t);
-            if(/*(_plant_phase == plant::INITIAL or _plant_phase == plant::VEGETATIVE)*/ !(_plant_state & plant::INDIV)) {
+            if(/*(_plant_phase == plant::INITIAL or _plant_phase == plant::VEGETATIVE)*/ !indiv) {
                 if(!(*culms)->get < bool, CulmModel >(t-1, CulmModel::KILL_CULM)) {
                     (*culms)->thermaltime_model()->put < double >(t, ThermalTimeModel::DELTA_T, _deltaT);
                     (*culms)->thermaltime_model()->put < double >(t, ThermalTimeModel::PLASTO_DELAY, _leaf_delay);
@@ -352,7 +389,6 @@ public:
                 }
             } else {
                 if(!(*culms)->get < bool, CulmModel >(t-1, CulmModel::KILL_CULM)) {
-                    (*culms)->thermaltime_modelNG()->put < double >(t, ThermalTimeModelNG::DELTA_T, _deltaT);
                     (*culms)->thermaltime_modelNG()->put < double >(t, ThermalTimeModelNG::DELTA_T, _deltaT);
                     (*culms)->thermaltime_modelNG()->put < plant::plant_state >(t, ThermalTimeModelNG::PLANT_STATE, _plant_state);
                     (*culms)->compute_thermaltimeNG(t);
@@ -382,14 +418,14 @@ public:
         (*_water_balance_model)(t);
 
         // Manager
-        //std::cout << t - _parameters.beginDate << std::endl;
+        //std::cout << t - _parameters->beginDate << std::endl;
         //std::cout << "Plant state :" << _plant_state << std::endl;
         //std::cout << "Plant phase :" << _plant_phase << std::endl;
         step_state(t);
         //std::cout << "Plant state :" << _plant_state << std::endl;
         //std::cout << "Plant phase :" << _plant_phase << std::endl;
         //if(_plant_phase == plant::MATURITY) {
-        //std::cout << "FIRST DAY OF MATURITY : " << t - _parameters.beginDate << std::endl;
+        //std::cout << "FIRST DAY OF MATURITY : " << t - _parameters->beginDate << std::endl;
         //}
 
         //LLBL - MGR
@@ -403,7 +439,7 @@ public:
         //Tillering
         double ic = _stock_model->get < double >(t-1, PlantStockModel::IC);
 
-        std::deque < CulmModel* >::const_iterator it = _culm_models.begin();
+        std::vector < CulmModel* >::const_iterator it = _culm_models.begin();
         _tae = 0;
         while(it != _culm_models.end()) {
             if(!(*it)->get < bool, CulmModel >(t-1, CulmModel::KILL_CULM) and (*it)->get < bool, CulmModel >(t-1, CulmModel::IS_COMPUTED)) {
@@ -442,13 +478,13 @@ public:
 
         //Lig update
         _lig_1 = _lig;
-        std::deque < CulmModel* >::const_iterator mainstem = _culm_models.begin();
+        std::vector < CulmModel* >::const_iterator mainstem = _culm_models.begin();
         _lig = (*mainstem)->get <double, CulmModel>(t, CulmModel::NB_LIG_TOT);
         _app = (*mainstem)->get < double, CulmModel >(t, CulmModel::NB_APP_LEAVES_TOT);
         _visi = (*mainstem)->get < double, CulmModel >(t, CulmModel::NB_APP_LEAVES);
 
         //TT_Lig
-        if (t != _parameters.beginDate) {
+        if (t != _parameters->beginDate) {
             if (_lig_1 == _lig) {
                 if (!(_plant_state & plant::NOGROWTH)) {
                     _TT_lig = _TT_lig + _EDD;
@@ -468,7 +504,7 @@ public:
             _interception_model->put < double >(t, InterceptionModel::PAI, _leaf_blade_area_sum);
             (*_interception_model)(t);
             _assimilation_model->put < double >(t, AssimilationModel::EXT_INTERC,
-                                                _interception_model->get < double >(t, InterceptionModel::INTERC)/_parameters.get(t).Par);
+                                                _interception_model->get < double >(t, InterceptionModel::INTERC)/_parameters->get(t).Par);
         } else {
             _assimilation_model->put < double >(t, AssimilationModel::EXT_INTERC,0);
         }
@@ -609,7 +645,7 @@ public:
         _paniclenb = 0;
         _tillerleafFW = 0;
         _nbleafplant = 0;
-        std::deque < CulmModel* >::const_iterator itnbc = _culm_models.begin();
+        std::vector < CulmModel* >::const_iterator itnbc = _culm_models.begin();
         while(itnbc != _culm_models.end()) {
             if(!((*itnbc)->get < bool, CulmModel >(t, CulmModel::KILL_CULM)) and (*itnbc)->get < bool, CulmModel >(t, CulmModel::IS_COMPUTED)) {
                 nbc++;
@@ -645,7 +681,7 @@ public:
         // VISU
         _tillerNb_1 = nbc;
         _createdTillers = nbtc;
-        std::deque < CulmModel* >::const_iterator visumainstem = _culm_models.begin();
+        std::vector < CulmModel* >::const_iterator visumainstem = _culm_models.begin();
         _ms_leaf2_len = (*visumainstem)->get< double, CulmModel >(t, CulmModel::FIRST_LEAF_TOT_LEN); //feuille numéro 2 pour avoir la croissance totale
         _ms_index = (*visumainstem)->get_phytomer_number();
         _biomLeafMainstemstruct = (*visumainstem)->get< double, CulmModel >(t, CulmModel::LEAF_BIOMASS_SUM);
@@ -674,47 +710,60 @@ public:
 
     void create_culm(double t, int n) {
         for (int i = 0; i < n; ++i) {
-            CulmModel* meristem = new CulmModel(_culm_models.size() + 1);
+            CulmModel* meristem = _arena->create<CulmModel>(_culm_models.size() + 1, *_arena);
             setsubmodel(CULMS, meristem);
             meristem->put(t, CulmModel::LL_BL, _LL_BL);
             meristem->put(t, CulmModel::PLANT_PHENOSTAGE, _phenostage);
-            meristem->init(t, _parameters);
+            meristem->init(t, *_parameters);
             _culm_models.push_back(meristem);
         }
     }
 
     void compute_culms(double t) {
-        std::deque < CulmModel* >::const_iterator it = _culm_models.begin();
-        while (it != _culm_models.end()) {
-            (*it)->put(t, CulmModel::MS_PHYT_INDEX, _ms_index);
-            (*it)->put(t, CulmModel::PLANT_BOOL_CROSSED_PLASTO, _bool_crossed_plasto);
-            (*it)->put(t, CulmModel::MS_SHEATH_LLL, _sheath_LLL);
-            (*it)->put(t, CulmModel::DD, _DD);
-            (*it)->put(t, CulmModel::EDD, _EDD);
-            (*it)->put(t, CulmModel::DELTA_T, _deltaT);
-            (*it)->put(t, CulmModel::FTSW, _water_balance_model->get < double >(t, WaterBalanceModel::FTSW));
-            (*it)->put(t, CulmModel::FCSTR, _water_balance_model->get < double >(t, WaterBalanceModel::FCSTR));
-            (*it)->put(t, CulmModel::FCSTRI, _water_balance_model->get < double >(t, WaterBalanceModel::FCSTRI));
-            (*it)->put(t, CulmModel::FCSTRL, _water_balance_model->get < double >(t, WaterBalanceModel::FCSTRL));
-            (*it)->put(t, CulmModel::FCSTRLLEN, _water_balance_model->get < double >(t, WaterBalanceModel::FCSTRLLEN));
-            (*it)->put < int > (t, CulmModel::PLANT_PHENOSTAGE, _phenostage);
-            (*it)->put < int > (t, CulmModel::PLANT_APPSTAGE, _appstage);
-            (*it)->put < int > (t, CulmModel::PLANT_LIGSTAGE, _ligstage);
-            (*it)->put(t, CulmModel::PREDIM_LEAF_ON_MAINSTEM, _predim_leaf_on_mainstem);
-            (*it)->put(t, CulmModel::PREDIM_APP_LEAF_MS, _predim_app_leaf_on_mainstem);
-            (*it)->put(t, CulmModel::SLA, _sla);
-            (*it)->put < plant::plant_state >(t, CulmModel::PLANT_STATE, _plant_state);
-            (*it)->put < plant::plant_phase >(t, CulmModel::PLANT_PHASE, _plant_phase);
-            (*it)->put(t, CulmModel::TEST_IC, _stock_model->get < double >(t-1, PlantStockModel::TEST_IC));
-            (*it)->put(t, CulmModel::PLANT_STOCK, _stock);
-            (*it)->put(t, CulmModel::PLANT_DEFICIT, _deficit);
-            (*it)->put(t, CulmModel::ASSIM, _assimilation_model->get < double >(t-1, AssimilationModel::ASSIM));
-            (*it)->put(t, CulmModel::MGR, _MGR);
-            (*it)->put(t, CulmModel::LL_BL, _LL_BL);
-            (*it)->put(t, CulmModel::IS_FIRST_DAY_PI, _is_first_day_pi);
-            (**it)(t);
-            ++it;
-        }
+        double ftsw = _water_balance_model->get < double >(t, WaterBalanceModel::FTSW);
+        double fcstr = _water_balance_model->get < double >(t, WaterBalanceModel::FCSTR);
+        double fcstri = _water_balance_model->get < double >(t, WaterBalanceModel::FCSTRI);
+        double fcstrl = _water_balance_model->get < double >(t, WaterBalanceModel::FCSTRL);
+        double fcstrllen = _water_balance_model->get < double >(t, WaterBalanceModel::FCSTRLLEN);
+        double test_ic = _stock_model->get < double >(t-1, PlantStockModel::TEST_IC);
+        double assim = _assimilation_model->get < double >(t-1, AssimilationModel::ASSIM);
+        // culms only read the plant and write their own state: they may be
+        // computed in any order, the sums below keep the culm order
+        std::function < void(size_t) > compute = [&](size_t i) {
+            CulmModel* culm = _culm_models[i];
+            culm->put(t, CulmModel::MS_PHYT_INDEX, _ms_index);
+            culm->put(t, CulmModel::PLANT_BOOL_CROSSED_PLASTO, _bool_crossed_plasto);
+            culm->put(t, CulmModel::MS_SHEATH_LLL, _sheath_LLL);
+            culm->put(t, CulmModel::DD, _DD);
+            culm->put(t, CulmModel::EDD, _EDD);
+            culm->put(t, CulmModel::DELTA_T, _deltaT);
+            culm->put(t, CulmModel::FTSW, ftsw);
+            culm->put(t, CulmModel::FCSTR, fcstr);
+            culm->put(t, CulmModel::FCSTRI, fcstri);
+            culm->put(t, CulmModel::FCSTRL, fcstrl);
+            culm->put(t, CulmModel::FCSTRLLEN, fcstrllen);
+            culm->put < int > (t, CulmModel::PLANT_PHENOSTAGE, _phenostage);
+            culm->put < int > (t, CulmModel::PLANT_APPSTAGE, _appstage);
+            culm->put < int > (t, CulmModel::PLANT_LIGSTAGE, _ligstage);
+            culm->put(t, CulmModel::PREDIM_LEAF_ON_MAINSTEM, _predim_leaf_on_mainstem);
+            culm->put(t, CulmModel::PREDIM_APP_LEAF_MS, _predim_app_leaf_on_mainstem);
+            culm->put(t, CulmModel::SLA, _sla);
+            culm->put < plant::plant_state >(t, CulmModel::PLANT_STATE, _plant_state);
+            culm->put < plant::plant_phase >(t, CulmModel::PLANT_PHASE, _plant_phase);
+            culm->put(t, CulmModel::TEST_IC, test_ic);
+            culm->put(t, CulmModel::PLANT_STOCK, _stock);
+            culm->put(t, CulmModel::PLANT_DEFICIT, _deficit);
+            culm->put(t, CulmModel::ASSIM, assim);
+            culm->put(t, CulmModel::MGR, _MGR);
+            culm->put(t, CulmModel::LL_BL, _LL_BL);
+            culm->put(t, CulmModel::IS_FIRST_DAY_PI, _is_first_day_pi);
+            (*culm)(t);
+        };
+        if (_culm_pool)
+            _culm_pool->run(_culm_models.size(), compute);
+        else
+            for (size_t i = 0; i < _culm_models.size(); ++i)
+                compute(i);
 
         _leaf_biomass_sum = 0;
         _last_leaf_biomass_sum = 0;
@@ -733,7 +782,7 @@ public:
         _peduncle_biomass_sum = 0;
         _realloc_sum_supply = 0;
 
-        it = _culm_models.begin();
+        std::vector < CulmModel* >::const_iterator it = _culm_models.begin();
         _predim_leaf_on_mainstem = (*it)->get < double, CulmModel > (t, CulmModel::STEM_LEAF_PREDIM);
         _predim_app_leaf_on_mainstem = (*it)->get < double, CulmModel > (t, CulmModel::STEM_APP_LEAF_PREDIM);
         _sheath_LLL = (*it)->get < double, CulmModel >(t, CulmModel::SHEATH_LLL);
@@ -798,10 +847,10 @@ public:
         _deleted_leaf_blade_area = 0;
         _qty = 0;
         if (_stock_model->get < double >(t, PlantStockModel::STOCK) == 0) {
-            std::deque < CulmModel* >::const_iterator it = _culm_models.begin();
+            std::vector < CulmModel* >::const_iterator it = _culm_models.begin();
             if(/*_plant_phase == plant::INITIAL or _plant_phase == plant::VEGETATIVE*/ !(_plant_state & plant::INDIV)) {
                 double tmp_date = t;
-                std::deque < CulmModel* >::const_iterator it = _culm_models.begin();
+                std::vector < CulmModel* >::const_iterator it = _culm_models.begin();
                 int i = 0;
                 while (it != _culm_models.end()) {
                     double creation_date = (*it)->get_first_alive_leaf_creation_date(t);
@@ -829,39 +878,39 @@ public:
 
     void init(double t, const ecomeristem::ModelParameters& parameters) {
         //parameters
-        _parameters = parameters;
-        _nbleaf_enabling_tillering = _parameters.get("nb_leaf_enabling_tillering");
-        _LL_BL_init = _parameters.get("LL_BL_init");
-        _nb_leaf_param2 = _parameters.get("nb_leaf_param2");
-        _slope_LL_BL_at_PI = _parameters.get("slope_LL_BL_at_PI");
-        _nb_leaf_enabling_tillering = _parameters.get("nb_leaf_enabling_tillering");
-        _coeff_MGR_PI = _parameters.get("coef_MGR_PI");
-        _nb_leaf_stem_elong = _parameters.get("nb_leaf_stem_elong");
-        _phenostage_pre_flo_to_flo  = _parameters.get("phenostage_PRE_FLO_to_FLO");
-        _phenostage_to_end_filling = _parameters.get("phenostage_to_end_filling");
-        _phenostage_to_maturity = _parameters.get("phenostage_to_maturity");
-        _Ict = _parameters.get("Ict");
-        _leaf_stock_max = _parameters.get("leaf_stock_max");
-        _realocationCoeff = _parameters.get("realocationCoeff");
-        _FSLA = _parameters.get("FSLA");
-        _plasto_init = _parameters.get("plasto_init");
-        _ligulo_init = _parameters.get("ligulo_init");
-        _phyllo_init = _parameters.get("phyllo_init");
-        _SLAp = _parameters.get("SLAp");
-        _Tb = _parameters.get("Tb");
-        _maxleaves = _parameters.get("maxleaves");
-        _G_L = parameters.get("G_L");
-        _intercmodel = parameters.get("intercmodel");
-        _leaf_FW_DW = parameters.get("leaf_FW_DW");
-        _internode_FW_DW = parameters.get("internode_FW_DW");
-        _nb_leaf_indiv = parameters.get("nb_leaf_indiv");
+        _parameters = &parameters;
+        _nbleaf_enabling_tillering = _parameters->get(parameter::nb_leaf_enabling_tillering);
+        _LL_BL_init = _parameters->get(parameter::LL_BL_init);
+        _nb_leaf_param2 = _parameters->get(parameter::nb_leaf_param2);
+        _slope_LL_BL_at_PI = _parameters->get(parameter::slope_LL_BL_at_PI);
+        _nb_leaf_enabling_tillering = _parameters->get(parameter::nb_leaf_enabling_tillering);
+        _coeff_MGR_PI = _parameters->get(parameter::coef_MGR_PI);
+        _nb_leaf_stem_elong = _parameters->get(parameter::nb_leaf_stem_elong);
+        _phenostage_pre_flo_to_flo  = _parameters->get(parameter::phenostage_PRE_FLO_to_FLO);
+        _phenostage_to_end_filling = _parameters->get(parameter::phenostage_to_end_filling);
+        _phenostage_to_maturity = _parameters->get(parameter::phenostage_to_maturity);
+        _Ict = _parameters->get(parameter::Ict);
+        _leaf_stock_max = _parameters->get(parameter::leaf_stock_max);
+        _realocationCoeff = _parameters->get(parameter::realocationCoeff);
+        _FSLA = _parameters->get(parameter::FSLA);
+        _plasto_init = _parameters->get(parameter::plasto_init);
+        _ligulo_init = _parameters->get(parameter::ligulo_init);
+        _phyllo_init = _parameters->get(parameter::phyllo_init);
+        _SLAp = _parameters->get(parameter::SLAp);
+        _Tb = _parameters->get(parameter::Tb);
+        _maxleaves = _parameters->get(parameter::maxleaves);
+        _G_L = parameters.get(parameter::G_L);
+        _intercmodel = parameters.get(parameter::intercmodel);
+        _leaf_FW_DW = parameters.get(parameter::leaf_FW_DW);
+        _internode_FW_DW = parameters.get(parameter::internode_FW_DW);
+        _nb_leaf_indiv = parameters.get(parameter::nb_leaf_indiv);
 
         //Attributes for culmmodel
         _LL_BL = _LL_BL_init;
         _phenostage = 4;
 
         //local init
-        CulmModel* meristem = new CulmModel(1);
+        CulmModel* meristem = _arena->create<CulmModel>(1, *_arena);
         setsubmodel(CULMS, meristem);
         meristem->put(t, CulmModel::LL_BL, _LL_BL);
         meristem->put(t, CulmModel::PLANT_PHENOSTAGE, _phenostage);
@@ -902,7 +951,7 @@ public:
         _plant_state = plant::NO_STATE;
         _height = 0;
         _height_ped = 0;
-        _MGR = parameters.get("MGR_init");
+        _MGR = parameters.get(parameter::MGR_init);
         _TT_lig = 0;
         _IH = 0;
         _biomLeaf = 0;
@@ -997,9 +1046,11 @@ public:
 private:
     double _last_time;
 
-    ecomeristem::ModelParameters _parameters;
+    const ecomeristem::ModelParameters * _parameters;
+    SimpleArena * _arena;
     // submodels
-    std::deque < CulmModel* > _culm_models;
+    std::vector < CulmModel* > _culm_models;
+    std::unique_ptr < SimplePool > _culm_pool;
     std::unique_ptr < model::WaterBalanceModel > _water_balance_model;
     std::unique_ptr < model::PlantStockModel > _stock_model;
     std::unique_ptr < model::AssimilationModel > _assimilation_model;
@@ -66,14 +66,14 @@ public:
 
     void compute(double t, bool /* update */) {
         // parameters
-        _P = _parameters.get(t).P;
+        _P = _parameters->get(t).P;
 
         // Root Demand Coef
-        _root_demand_coef = _coeff1_R_d * std::exp(_coeff2_R_d * (t - _parameters.beginDate + 1)) * (_P * _resp_R_d + 1);
+        _root_demand_coef = _coeff1_R_d * std::exp(_coeff2_R_d * (t - _parameters->beginDate + 1)) * (_P * _resp_R_d + 1);
 
         // Root Demand
         _last_root_demand = _root_demand;
-        if (t == _parameters.beginDate) {
+        if (t == _parameters->beginDate) {
             _root_demand = (_leaf_demand_sum + _leaf_last_demand_sum +
                             _internode_demand_sum) * _root_demand_coef;
             _last_value = _root_demand;
@@ -124,12 +124,12 @@ public:
     }
 
     void init(double t, const ecomeristem::ModelParameters& parameters) {
-        _parameters = parameters;
+        _parameters = &parameters;
 
         //    parameters variables
-        _coeff1_R_d = _parameters.get("coeff1_R_d");
-        _coeff2_R_d = _parameters.get("coeff2_R_d");
-        _resp_R_d = _parameters.get("resp_R_d");
+        _coeff1_R_d = _parameters->get(parameter::coeff1_R_d);
+        _coeff2_R_d = _parameters->get(parameter::coeff2_R_d);
+        _resp_R_d = _parameters->get(parameter::resp_R_d);
 
         //    computed variables (internal)
         _root_demand = 0;
@@ -141,7 +141,7 @@ public:
     }
 
 private:
-    ecomeristem::ModelParameters _parameters;
+    const ecomeristem::ModelParameters * _parameters;
     //    parameters
     double _coeff1_R_d;
     double _coeff2_R_d;
@@ -85,11 +85,11 @@ public:
     }
 
     void init(double t, const ecomeristem::ModelParameters& parameters) {
-        _parameters = parameters;
+        _parameters = &parameters;
         // Parameters
-        _spike_creation_rate = _parameters.get("spike_creation_rate");
-        _grain_filling_rate = _parameters.get("grain_filling_rate");
-        _gdw = _parameters.get("gdw");
+        _spike_creation_rate = _parameters->get(parameter::spike_creation_rate);
+        _grain_filling_rate = _parameters->get(parameter::grain_filling_rate);
+        _gdw = _parameters->get(parameter::gdw);
 
         // Internals
         _preflo_passed = false;
@@ -103,7 +103,7 @@ public:
 
 
 private:
-    ecomeristem::ModelParameters _parameters;
+    const ecomeristem::ModelParameters * _parameters;
 
     // Parameters
     double _spike_creation_rate;
@@ -74,7 +74,7 @@ public:
 
     void compute(double t, bool /* update */)
     {
-        _p = _parameters.get(t).P;
+        _p = _parameters->get(t).P;
         if(t == _first_day) {
             //Peduncle Length Predim
             _length_predim = _ratio_in_ped * _inter_predim;
@@ -132,16 +132,16 @@ public:
 
     void init(double t, const ecomeristem::ModelParameters&  parameters )
     {
-        _parameters = parameters;
+        _parameters = &parameters;
 
         // parameters
-        _ratio_in_ped = _parameters.get("ratio_INPed");
-        _peduncle_diam = _parameters.get("peduncle_diam");
-        _respINER = _parameters.get("resp_LER");
-        _thresINER = _parameters.get("thresINER");
-        _density = _parameters.get("density_IN2");
-        _wbmodel = _parameters.get("wbmodel");
-        _phenostage_pre_flo_to_flo = parameters.get("phenostage_PRE_FLO_to_FLO");
+        _ratio_in_ped = _parameters->get(parameter::ratio_INPed);
+        _peduncle_diam = _parameters->get(parameter::peduncle_diam);
+        _respINER = _parameters->get(parameter::resp_LER);
+        _thresINER = _parameters->get(parameter::thresINER);
+        _density = _parameters->get(parameter::density_IN2);
+        _wbmodel = _parameters->get(parameter::wbmodel);
+        _phenostage_pre_flo_to_flo = parameters.get(parameter::phenostage_PRE_FLO_to_FLO);
 
         // internals
         _is_mature = false;
@@ -158,7 +158,7 @@ public:
         _last_demand = 0;
     }
 private:
-    ecomeristem::ModelParameters  _parameters;
+    const ecomeristem::ModelParameters * _parameters;
 
     // attributes
     int _index;
@@ -261,19 +261,19 @@ public:
     void init(double t, const ecomeristem::ModelParameters& parameters) {
         _parameters = &parameters;
         //parameters
-        _slope_length_IN = parameters.get("slope_length_IN");
-        _leaf_length_to_IN_length = parameters.get("leaf_length_to_IN_length");
-        _nb_leaf_param2 = parameters.get("nb_leaf_param2");
-        _thresINER = parameters.get("thresINER");
-        _respINER = parameters.get("resp_LER");
-        _coef_lin_IN_diam = parameters.get("coef_lin_IN_diam");
-        _density_IN1 = parameters.get("density_IN1");
-        _density_IN2 = parameters.get("density_IN2");
-        _nb_leaf_stem_elong = parameters.get("nb_leaf_stem_elong");
-        _phenostage_pre_flo_to_flo = parameters.get("phenostage_PRE_FLO_to_FLO");
-        _wbmodel = parameters.get("wbmodel");
-        _maxleaves = parameters.get("maxleaves");
-        _coeff_in_diam = parameters.get("coeff_in_diam");
+        _slope_length_IN = parameters.get(parameter::slope_length_IN);
+        _leaf_length_to_IN_length = parameters.get(parameter::leaf_length_to_IN_length);
+        _nb_leaf_param2 = parameters.get(parameter::nb_leaf_param2);
+        _thresINER = parameters.get(parameter::thresINER);
+        _respINER = parameters.get(parameter::resp_LER);
+        _coef_lin_IN_diam = parameters.get(parameter::coef_lin_IN_diam);
+        _density_IN1 = parameters.get(parameter::density_IN1);
+        _density_IN2 = parameters.get(parameter::density_IN2);
+        _nb_leaf_stem_elong = parameters.get(parameter::nb_leaf_stem_elong);
+        _phenostage_pre_flo_to_flo = parameters.get(parameter::phenostage_PRE_FLO_to_FLO);
+        _wbmodel = parameters.get(parameter::wbmodel);
+        _maxleaves = parameters.get(parameter::maxleaves);
+        _coeff_in_diam = parameters.get(parameter::coeff_in_diam);
 
 
         //internals
@@ -401,21 +401,21 @@ public:
         _parameters = &parameters;
 
         //parameters
-        _coeffLifespan = parameters.get("coeff_lifespan");
-        _mu = parameters.get("mu");
-        _Lef1 = parameters.get("Lef1");
-        _thresLER = parameters.get("thresLER");
-        _WLR = parameters.get("WLR");
-        _respLER = parameters.get("resp_LER");
-        _allo_area = parameters.get("allo_area");
-        _G_L = parameters.get("G_L");
-        _realocationCoeff = parameters.get("realocationCoeff");
-        _nbinitleaves = parameters.get("nbinitleaves");
-        _wbmodel = parameters.get("wbmodel");
-        _phyllo_init = parameters.get("phyllo_init");
-        _plasto_init = parameters.get("plasto_init");
-        _ligulo_init = parameters.get("ligulo_init");
-        coeff_sen = parameters.get("coeff_sen");
+        _coeffLifespan = parameters.get(parameter::coeff_lifespan);
+        _mu = parameters.get(parameter::mu);
+        _Lef1 = parameters.get(parameter::Lef1);
+        _thresLER = parameters.get(parameter::thresLER);
+        _WLR = parameters.get(parameter::WLR);
+        _respLER = parameters.get(parameter::resp_LER);
+        _allo_area = parameters.get(parameter::allo_area);
+        _G_L = parameters.get(parameter::G_L);
+        _realocationCoeff = parameters.get(parameter::realocationCoeff);
+        _nbinitleaves = parameters.get(parameter::nbinitleaves);
+        _wbmodel = parameters.get(parameter::wbmodel);
+        _phyllo_init = parameters.get(parameter::phyllo_init);
+        _plasto_init = parameters.get(parameter::plasto_init);
+        _ligulo_init = parameters.get(parameter::ligulo_init);
+        coeff_sen = parameters.get(parameter::coeff_sen);
 
         //internals
         _realloc_biomass = 0;
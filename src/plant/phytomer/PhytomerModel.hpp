@@ -52,12 +52,12 @@ public:
         _LL_BL(LL_BL),
         _is_last_phytomer(is_last_phytomer),
         _is_on_mainstem(is_on_mainstem),
-        _internode_model(new InternodeModel(_index, _is_on_mainstem, _is_last_phytomer)),
-        _leaf_model(new LeafModel(_index, _is_on_mainstem, _plasto, _phyllo, _ligulo, _LL_BL))
+        _internode_model(_index, _is_on_mainstem, _is_last_phytomer),
+        _leaf_model(_index, _is_on_mainstem, _plasto, _phyllo, _ligulo, _LL_BL)
     {
         // submodels
-        setsubmodel(LEAF, _leaf_model.get());
-        setsubmodel(INTERNODE, _internode_model.get());
+        setsubmodel(LEAF, &_leaf_model);
+        setsubmodel(INTERNODE, &_internode_model);
 
         // internals
         Internal(KILL_LEAF, &PhytomerModel::_kill_leaf);
@@ -90,16 +90,13 @@ public:
     }
 
     virtual ~PhytomerModel()
-    {
-        _internode_model.reset(nullptr);
-        _leaf_model.reset(nullptr);
-    }
+    { }
 
     void init(double t, const ecomeristem::ModelParameters& parameters)
     {
         // submodels
-        _internode_model->init(t, parameters);
-        _leaf_model->init(t, parameters);
+        _internode_model.init(t, parameters);
+        _leaf_model.init(t, parameters);
 
         _kill_leaf = false;
         _leaf_predim = 0;
@@ -121,79 +118,75 @@ public:
 
     void compute(double t, bool /* update */)
     {
-        if (_leaf_model) {
-            _leaf_model->put(t, LeafModel::KILL_LEAF, _kill_leaf);
-            _leaf_model->put(t, LeafModel::DELTA_T, _delta_t);
-            _leaf_model->put(t, LeafModel::FTSW, _ftsw);
-            _leaf_model->put(t, LeafModel::FCSTR, _fcstr);
-            _leaf_model->put(t, LeafModel::LEAF_PREDIM_ON_MAINSTEM, _predim_leaf_on_mainstem);
-            _leaf_model->put(t, LeafModel::PREVIOUS_LEAF_PREDIM, _predim_previous_leaf);
-            _leaf_model->put(t, LeafModel::SLA, _sla);
-            _leaf_model->put < plant::plant_state >(t, LeafModel::PLANT_STATE, _plant_state);
-            _leaf_model->put(t, LeafModel::TEST_IC, _test_ic);
-            (*_leaf_model)(t);
-            _leaf_predim = _leaf_model->get< double >(t, LeafModel::LEAF_PREDIM);
-            _leaf_biomass = _leaf_model->get< double >(t, LeafModel::BIOMASS);
-            _leaf_blade_area = _leaf_model->get< double >(t, LeafModel::BLADE_AREA);
-            _leaf_visible_blade_area = _leaf_model->get< double >(t, LeafModel::VISIBLE_BLADE_AREA);
-            _leaf_demand = _leaf_model->get< double >(t, LeafModel::DEMAND);
-            _leaf_last_demand = _leaf_model->get< double >(t, LeafModel::LAST_DEMAND);
-            _realloc_biomass = _leaf_model->get< double >(t, LeafModel::REALLOC_BIOMASS);
-            _senesc_dw = _leaf_model->get< double >(t, LeafModel::SENESC_DW);
-            _senesc_dw_sum = _leaf_model->get< double >(t, LeafModel::SENESC_DW_SUM);
-            _leaf_len = _leaf_model->get< double >(t, LeafModel::LEAF_LEN);
-        }
-
-        if(_internode_model) {
-            _internode_model->put(t, InternodeModel::DELTA_T, _delta_t);
-            _internode_model->put(t, InternodeModel::FTSW, _ftsw);
-            _internode_model->put(t, InternodeModel::FCSTR, _fcstr);
-            _internode_model->put < plant::plant_state >(t, InternodeModel::PLANT_STATE, _plant_state);
-            _internode_model->put < plant::plant_phase >(t, InternodeModel::PLANT_PHASE, _plant_phase);
-            _internode_model->put(t, InternodeModel::LIG, _leaf_model->get < double > (t, LeafModel::LIG_T));
-            _internode_model->put(t, InternodeModel::LEAF_PREDIM, _leaf_model->get < double > (t, LeafModel::LEAF_PREDIM));
-            _internode_model->put(t, InternodeModel::IS_LIG, _leaf_model->get < bool > (t, LeafModel::IS_LIG));
-            _internode_model->put(t, InternodeModel::TEST_IC, _test_ic);
-            (*_internode_model)(t);
-            _internode_last_demand = _internode_model->get< double >(t, InternodeModel::LAST_DEMAND);
-            _internode_demand = _internode_model->get< double >(t, InternodeModel::DEMAND);
-            _internode_biomass = _internode_model->get< double >(t, InternodeModel::BIOMASS);
-            _internode_len = _internode_model->get< double >(t, InternodeModel::INTERNODE_LEN);
-        }
+        _leaf_model.put(t, LeafModel::KILL_LEAF, _kill_leaf);
+        _leaf_model.put(t, LeafModel::DELTA_T, _delta_t);
+        _leaf_model.put(t, LeafModel::FTSW, _ftsw);
+        _leaf_model.put(t, LeafModel::FCSTR, _fcstr);
+        _leaf_model.put(t, LeafModel::LEAF_PREDIM_ON_MAINSTEM, _predim_leaf_on_mainstem);
+        _leaf_model.put(t, LeafModel::PREVIOUS_LEAF_PREDIM, _predim_previous_leaf);
+        _leaf_model.put(t, LeafModel::SLA, _sla);
+        _leaf_model.put < plant::plant_state >(t, LeafModel::PLANT_STATE, _plant_state);
+        _leaf_model.put(t, LeafModel::TEST_IC, _test_ic);
+        _leaf_model(t);
+        _leaf_predim = _leaf_model.get< double >(t, LeafModel::LEAF_PREDIM);
+        _leaf_biomass = _leaf_model.get< double >(t, LeafModel::BIOMASS);
+        _leaf_blade_area = _leaf_model.get< double >(t, LeafModel::BLADE_AREA);
+        _leaf_visible_blade_area = _leaf_model.get< double >(t, LeafModel::VISIBLE_BLADE_AREA);
+        _leaf_demand = _leaf_model.get< double >(t, LeafModel::DEMAND);
+        _leaf_last_demand = _leaf_model.get< double >(t, LeafModel::LAST_DEMAND);
+        _realloc_biomass = _leaf_model.get< double >(t, LeafModel::REALLOC_BIOMASS);
+        _senesc_dw = _leaf_model.get< double >(t, LeafModel::SENESC_DW);
+        _senesc_dw_sum = _leaf_model.get< double >(t, LeafModel::SENESC_DW_SUM);
+        _leaf_len = _leaf_model.get< double >(t, LeafModel::LEAF_LEN);
+
+        _internode_model.put(t, InternodeModel::DELTA_T, _delta_t);
+        _internode_model.put(t, InternodeModel::FTSW, _ftsw);
+        _internode_model.put(t, InternodeModel::FCSTR, _fcstr);
+        _internode_model.put < plant::plant_state >(t, InternodeModel::PLANT_STATE, _plant_state);
+        _internode_model.put < plant::plant_phase >(t, InternodeModel::PLANT_PHASE, _plant_phase);
+        _internode_model.put(t, InternodeModel::LIG, _leaf_model.get < double > (t, LeafModel::LIG_T));
+        _internode_model.put(t, InternodeModel::LEAF_PREDIM, _leaf_model.get < double > (t, LeafModel::LEAF_PREDIM));
+        _internode_model.put(t, InternodeModel::IS_LIG, _leaf_model.get < bool > (t, LeafModel::IS_LIG));
+        _internode_model.put(t, InternodeModel::TEST_IC, _test_ic);
+        _internode_model(t);
+        _internode_last_demand = _internode_model.get< double >(t, InternodeModel::LAST_DEMAND);
+        _internode_demand = _internode_model.get< double >(t, InternodeModel::DEMAND);
+        _internode_biomass = _internode_model.get< double >(t, InternodeModel::BIOMASS);
+        _internode_len = _internode_model.get< double >(t, InternodeModel::INTERNODE_LEN);
     }
 
     void kill_leaf(double t)
     { _kill_leaf = true; }
 
-    LeafModel * leaf() const
-    { return _leaf_model.get(); }
+    LeafModel * leaf()
+    { return &_leaf_model; }
 
-    InternodeModel * internode() const
-    { return _internode_model.get(); }
+    InternodeModel * internode()
+    { return &_internode_model; }
 
     int get_index() const
     { return _index; }
 
     bool is_leaf_dead(double t) const
     { return _kill_leaf ||
-                _leaf_model->get < bool >(t, LeafModel::IS_DEAD) ; }
+                _leaf_model.get < bool >(t, LeafModel::IS_DEAD) ; }
 
     bool is_leaf_lig(double t) const {
         return !is_leaf_dead(t) &&
-                _leaf_model->get < bool > (t, LeafModel::IS_LIG);
+                _leaf_model.get < bool > (t, LeafModel::IS_LIG);
     }
 
     bool is_leaf_app(double t) const {
         return !is_leaf_dead(t) &&
-                _leaf_model->get < bool > (t, LeafModel::IS_APP);
+                _leaf_model.get < bool > (t, LeafModel::IS_APP);
     }
 
     bool is_leaf_ligged(double t) const {
-        return _leaf_model->get < bool >(t, LeafModel::IS_LIG);
+        return _leaf_model.get < bool >(t, LeafModel::IS_LIG);
     }
 
     bool is_leaf_apped(double t) const {
-        return _leaf_model->get < bool >(t, LeafModel::IS_APP);
+        return _leaf_model.get < bool >(t, LeafModel::IS_APP);
     }
 
 
@@ -208,9 +201,9 @@ private:
     double _LL_BL;
     bool _is_last_phytomer;
 
-    // submodels
-    std::unique_ptr < InternodeModel > _internode_model;
-    std::unique_ptr < LeafModel > _leaf_model;
+    // submodels, kept inside the phytomer
+    InternodeModel _internode_model;
+    LeafModel _leaf_model;
 
     // internal
     bool _kill_leaf;
@@ -62,8 +62,8 @@ public:
 
     void compute(double t, bool /* update */) {
         // parameters
-        _Ta = _parameters.get(t).Temperature;
-        _radiation = _parameters.get(t).Par;
+        _Ta = _parameters->get(t).Temperature;
+        _radiation = _parameters->get(t).Par;
 
         //  lai
         _lai = _PAI * (_rolling_B + _rolling_A * _fcstr) * (_density / 1.e4);
@@ -95,22 +95,22 @@ public:
         last_time = t-1;
 
         //parameters
-        _parameters = parameters;
+        _parameters = &parameters;
 
         //  parameters variables
-        _density = parameters.get("density");
-        _power_for_cstr = parameters.get("power_for_cstr");
+        _density = parameters.get(parameter::density);
+        _power_for_cstr = parameters.get(parameter::power_for_cstr);
         _kpar = 1 /* parameters.get("kpar") */;
-        _epsib = parameters.get("Epsib");
-        _kdf = parameters.get("Kdf");
-        _rolling_A = parameters.get("Rolling_A");
-        _rolling_B = parameters.get("Rolling_B");
-        _Kresp_leaf = parameters.get("Kresp");
-        _Kresp_internode = parameters.get("Kresp_internode");
-        _Tresp = parameters.get("Tresp");
-        _thresAssim = parameters.get("thresAssim");
-        _wbmodel = parameters.get("wbmodel");
-        _intercmodel = parameters.get("intercmodel");
+        _epsib = parameters.get(parameter::Epsib);
+        _kdf = parameters.get(parameter::Kdf);
+        _rolling_A = parameters.get(parameter::Rolling_A);
+        _rolling_B = parameters.get(parameter::Rolling_B);
+        _Kresp_leaf = parameters.get(parameter::Kresp);
+        _Kresp_internode = parameters.get(parameter::Kresp_internode);
+        _Tresp = parameters.get(parameter::Tresp);
+        _thresAssim = parameters.get(parameter::thresAssim);
+        _wbmodel = parameters.get(parameter::wbmodel);
+        _intercmodel = parameters.get(parameter::intercmodel);
 
         //  computed variables (internal)
         _assim = 0;
@@ -122,7 +122,7 @@ public:
     }
 
 private:
-    ecomeristem::ModelParameters _parameters;
+    const ecomeristem::ModelParameters * _parameters;
 
     //  parameters
     double _density;
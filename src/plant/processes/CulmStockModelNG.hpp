@@ -201,11 +201,11 @@ public:
         last_time = t-1;
 
         // parameters
-        _parameters = parameters;
-        _maximum_reserve_in_internode = parameters.get("maximumReserveInInternode");
-        _leaf_stock_max = parameters.get("leaf_stock_max");
-        _coeff_remob = parameters.get("coeff_remob");
-        _coeff_active_storage_IN = parameters.get("coeff_active_storage_IN");
+        _parameters = &parameters;
+        _maximum_reserve_in_internode = parameters.get(parameter::maximumReserveInInternode);
+        _leaf_stock_max = parameters.get(parameter::leaf_stock_max);
+        _coeff_remob = parameters.get(parameter::coeff_remob);
+        _coeff_active_storage_IN = parameters.get(parameter::coeff_active_storage_IN);
 
         // internals
         _max_reservoir_dispo_internode = 0;
@@ -236,7 +236,7 @@ public:
     }
 
 private:
-    ecomeristem::ModelParameters _parameters;
+    const ecomeristem::ModelParameters * _parameters;
 
     //parameters
     double _coeff_remob;
@@ -55,7 +55,7 @@ public:
     {}
 
     void compute(double t, bool /* update */) {
-        if (t != _parameters.beginDate) {
+        if (t != _parameters->beginDate) {
             if(_is_computed) {
                 _ic_ = _ic_;
                 _ic = _ic;
@@ -106,8 +106,8 @@ public:
 
     void init(double t, const ecomeristem::ModelParameters& parameters) {
         //parameters
-        _parameters = parameters;
-        Ict = _parameters.get("Ict");
+        _parameters = &parameters;
+        Ict = _parameters->get(parameter::Ict);
 
         //internals
         _is_computed = false;
@@ -119,7 +119,7 @@ public:
     }
 
 private:
-    ecomeristem::ModelParameters _parameters;
+    const ecomeristem::ModelParameters * _parameters;
     //parameters
     double Ict;
 
@@ -30,9 +30,196 @@
 
 #include <defines.hpp>
 #include <random>
+#include <mutex>
+#include <algorithm>
 
 namespace model {
 
+//Solar geometry and hourly radiation of a day: they only depend on the day
+//of year, the site and the climate, not on the plant
+struct SolarDay {
+    double doy;
+    double Rg;
+    double declination;
+    double ahs;
+    double sunrise;
+    double sunset;
+    double dayDuration;
+    double mean;
+    double sigma;
+    double scd;
+    double sinLD;
+    double cosLD;
+    double dayLength;
+    double solarHeight;
+    double rExt;
+    double TransAtm;
+    double propRgRd;
+
+    //hourly diffuse and direct PAR absorbed by a canopy that intercepts all
+    double diffuse[24];
+    double direct[24];
+    //hourly extinction coefficient for direct radiation, null at night
+    double kpb[24];
+    //hours with direct radiation: [dawn, dusk)
+    int dawn;
+    int dusk;
+};
+
+//Site and canopy constants, and the computations that only depend on them
+struct SolarSite {
+    double ec = 0.48;
+    double latitudeRad = 43.6167 * 3.141592653589793238462643383280/180;
+    double pi = 3.141592653589793238462643383280;
+    double zeta = 0.2;
+    double leafAngle = 50;
+    double rho_cd = 0.057;
+
+    double compute_kd(double elevation) const {
+        double oav = 0;
+        if(elevation>=(leafAngle*pi/180)) {
+            oav = std::sin(elevation)*std::sin(leafAngle*pi/180);
+        } else {
+            oav = 2*((std::sin(elevation)*std::cos(leafAngle*pi/180) * std::asin(std::tan(elevation)/std::tan(leafAngle*pi/180)))+(std::sqrt(std::pow(std::sin(leafAngle*pi/180),2) - std::pow(std::sin(elevation),2))))/pi;
+        }
+        if(sin(elevation) != 0) {
+            return(oav/std::sin(elevation));
+        } else {
+            return(0);
+        }
+    }
+
+    void compute_day(double t, const ecomeristem::Climate& climate, SolarDay& day) const {
+        day.doy = JulianCalculator::dayNumber(t);
+
+        //Transform PAR in Global radiation
+        day.Rg = climate.Par / ec;
+
+        //Hourly Rg
+        day.declination = 23.45 * std::sin((2*pi*(day.doy+284))/366)*pi/180;
+        if(latitudeRad+day.declination < pi/2 && latitudeRad-day.declination < pi/2) { //normal day
+            day.ahs = std::acos(-std::tan(latitudeRad)*std::tan(day.declination));
+            day.sunrise = 12 - day.ahs*12/pi;
+            day.sunset = 12 + day.ahs*12/pi;
+        } else if(latitudeRad+day.declination >= pi/2) { //midnight sun
+            day.ahs = pi;
+            day.sunrise = 0;
+            day.sunset = 24;
+        } else { //perpetual night
+            day.ahs = pi;
+            day.sunrise = 12;
+            day.sunset = 12;
+        }
+        day.dayDuration = day.sunset - day.sunrise;
+        day.mean = day.sunrise + (day.sunset-day.sunrise)/2;
+        day.sigma = 0.15 * (day.sunset-day.sunrise);
+
+        double rgHourly[24];
+        double sinBeta[24];
+        for(int i=0; i<24; ++i) {
+            double x = ((i+1)-day.mean)/day.sigma;
+            double p;
+            if(x < 5) {
+                p = 1/std::sqrt(2*pi)*std::exp(-0.5*x*x)/day.sigma;
+            } else if(x > std::sqrt(-2*std::log(2)*-1073)) {
+                p = 0;
+            } else {
+                double x1 = std::ldexp(std::ldexp(x,16),-16);
+                double x2 = x-x1;
+                p = 1/std::sqrt(2*pi) / day.sigma * (std::exp(-0.5 * x1 * x1) * std::exp((-0.5*x2-x1)*x2));
+            }
+            rgHourly[i] = (p*day.Rg);
+            sinBeta[i] = std::max(0.0,std::sin(latitudeRad)*std::sin(day.declination)+std::cos(latitudeRad)*std::cos(day.declination)*cos(2*pi*(i+12)/24));
+        }
+
+        //Solar variables
+        //Solar constant at the top of the atmosphere for a certain day
+        day.scd = 1370*(1+0.033*std::cos(360*day.doy/365));
+        //Seasonal offset of the solar height at a certain day
+        day.sinLD = std::sin(latitudeRad)*std::sin(day.declination);
+        //Amplitude of sine of solar height at a certain day
+        day.cosLD = std::cos(latitudeRad)*std::cos(day.declination);
+        //Day length
+        day.dayLength = 12+24/pi*std::asin(day.sinLD/day.cosLD);
+        //Integral solar height
+        day.solarHeight = 3600*(day.dayLength*day.sinLD+24/pi*day.cosLD*std::sqrt(1-std::pow(day.sinLD/day.cosLD,2)));
+        //Daily extraterrestrial radiation
+        day.rExt = day.scd * day.solarHeight;
+        //Atmospheric transmissivity
+        day.TransAtm = day.Rg/(day.rExt/1000000);
+
+        //Diffuse and direct
+        if (day.TransAtm <= 0.07){
+            day.propRgRd = 1;
+        } else if ((day.TransAtm > 0.07) && (day.TransAtm <= 0.35))  {
+            day.propRgRd = 1 - 2.3*std::pow(day.TransAtm-0.07,2);
+        } else if ((day.TransAtm > 0.35) && (day.TransAtm <= 0.75)) {
+            day.propRgRd = 1.33 - 1.46*day.TransAtm;
+        } else {
+            day.propRgRd = 0.23;
+        }
+
+        //Canopy reflexion coefficient
+        double rho_h = (1-std::sqrt(1-zeta))/(1+std::sqrt(1-zeta));
+        for(int i=0; i<24; ++i) {
+            double rgHourly_diff = day.propRgRd * rgHourly[i];
+            double rgHourly_dir = rgHourly[i] - rgHourly_diff;
+            double kdr_bl = compute_kd(std::asin(sinBeta[i]));
+            double rho_cb = 1-std::exp((-2*rho_h*kdr_bl)/(1+kdr_bl));
+            day.kpb[i] = kdr_bl*std::sqrt(1-zeta);
+            day.diffuse[i] = ec * (1- rho_cd) * rgHourly_diff;
+            day.direct[i] = ec * (1- rho_cb) * rgHourly_dir;
+        }
+        day.dawn = 0;
+        while(day.dawn < 24 && day.kpb[day.dawn] == 0)
+            ++day.dawn;
+        day.dusk = 24;
+        while(day.dusk > day.dawn && day.kpb[day.dusk-1] == 0)
+            --day.dusk;
+    }
+};
+
+//SolarDay of each day of a shared meteo, computed once for all the
+//simulations using it, see ModelParameters::shareMeteo
+class SolarTable {
+public:
+    SolarTable(const std::shared_ptr < const std::vector < ecomeristem::Climate > >& meteo,
+               double begin) : _meteo(meteo), _begin(begin), _days(meteo->size()) {
+        SolarSite site;
+        for (size_t i = 0; i < _days.size(); ++i)
+            site.compute_day(begin + i, (*meteo)[i], _days[i]);
+    }
+
+    //day t, null when out of the meteo
+    const SolarDay * find(double t) const {
+        double i = t - _begin;
+        return i >= 0 && i < _days.size() ? &_days[static_cast < size_t >(i)] : nullptr;
+    }
+
+    //table of the shared meteo of parameters, null when they have none
+    static std::shared_ptr < const SolarTable > get(const ecomeristem::ModelParameters& parameters) {
+        std::shared_ptr < const std::vector < ecomeristem::Climate > > meteo = parameters.getSharedMeteo();
+        if (!meteo)
+            return nullptr;
+        static std::mutex mutex;
+        static std::vector < std::shared_ptr < const SolarTable > > tables;
+        std::lock_guard < std::mutex > lock(mutex);
+        tables.erase(std::remove_if(tables.begin(), tables.end(),
+                                    [](const std::shared_ptr < const SolarTable >& table) {
+                                        return table->_meteo.expired(); }), tables.end());
+        for (const std::shared_ptr < const SolarTable >& table : tables)
+            if (table->_meteo.lock() == meteo && table->_begin == parameters.beginDate)
+                return table;
+        tables.push_back(std::make_shared < const SolarTable >(meteo, parameters.beginDate));
+        return tables.back();
+    }
+
+private:
+    std::weak_ptr < const std::vector < ecomeristem::Climate > > _meteo;
+    double _begin;
+    std::vector < SolarDay > _days;
+};
+
 class InterceptionModel : public AtomicModel < InterceptionModel >
 {
 public:
@@ -78,39 +265,29 @@ public:
     {}
 
     void compute(double t, bool /* update */) {
-        // parameters
-        _Ta = _parameters.get(t).Temperature;
-        _radiation = _parameters.get(t).Par;
-        _doy = JulianCalculator::dayNumber(t);
-
-        //Transform PAR in Global radiation
-        _Rg = _radiation / _ec;
-
-        //Transform day Rg in hourly Rg
-        compute_HourlyRg();
-
-        //Solar variables
-        //Solar constant at the top of the atmosphere for a certain day
-        _scd = 1370*(1+0.033*std::cos(360*_doy/365));
-        //Seasonal offset of the solar height at a certain day
-        _sinLD = std::sin(_latitudeRad)*std::sin(_declination);
-        //Amplitude of sine of solar height at a certain day
-        _cosLD = std::cos(_latitudeRad)*std::cos(_declination);
-        //Day length
-        _dayLength = 12+24/_pi*std::asin(_sinLD/_cosLD);
-        //Integral solar height
-        _solarHeight = 3600*(_dayLength*_sinLD+24/_pi*_cosLD*std::sqrt(1-std::pow(_sinLD/_cosLD,2)));
-        //Daily extraterrestrial radiation
-        _rExt = _scd * _solarHeight;
-        //Atmospheric transmissivity
-        _TransAtm = _Rg/(_rExt/1000000);
-
-        //Compute diffuse and direct
-        compute_diff_dir();
-
-        //Compute canopy reflexion coefficient
-        double rho_h = (1-std::sqrt(1-_zeta))/(1+std::sqrt(1-_zeta));
-
+        //the day comes from the table of the environment when there is one
+        const SolarDay * day = _table ? _table->find(t) : nullptr;
+        if(!day) {
+            _site.compute_day(t, _parameters->get(t), _day);
+            day = &_day;
+        }
+        _doy = day->doy;
+        _Rg = day->Rg;
+        _declination = day->declination;
+        _ahs = day->ahs;
+        _sunrise = day->sunrise;
+        _sunset = day->sunset;
+        _dayDuration = day->dayDuration;
+        _mean = day->mean;
+        _sigma = day->sigma;
+        _scd = day->scd;
+        _sinLD = day->sinLD;
+        _cosLD = day->cosLD;
+        _dayLength = day->dayLength;
+        _solarHeight = day->solarHeight;
+        _rExt = day->rExt;
+        _TransAtm = day->TransAtm;
+        _propRgRd = day->propRgRd;
 
         //FOR EACH LAYER :
         _interc = 0;
@@ -120,116 +297,45 @@ public:
             _lai = _pai * (_density / 1.e4);
 
             //extinction coefficient for diffuse radiation
-            _kpd_15 = compute_kd((15*_pi)/180);
-            _kpd_45 = compute_kd((45*_pi)/180);
-            _kpd_75 = compute_kd((75*_pi)/180);
-            _alpha = std::sqrt(1-_zeta)*_lai;
+            _kpd_15 = _kd_15;
+            _kpd_45 = _kd_45;
+            _kpd_75 = _kd_75;
+            _alpha = std::sqrt(1-_site.zeta)*_lai;
             _kpd = -(1/_lai)*std::log(0.178*std::exp(-_kpd_15*_alpha)+0.514 * std::exp(-_kpd_45*_alpha)+0.308 * std::exp(-_kpd_75*_alpha));
 
-            //compute diffuse PAr and direct PAR
-            for(int i=0; i<24;++i) {
-                _elevation_[i] = std::asin(_sinBeta_[i]);
-                _kdr_bl_[i] = compute_kd(_elevation_[i]);
-                _rho_cb_[i] = 1-std::exp((-2*rho_h*_kdr_bl_[i])/(1+_kdr_bl_[i]));
-                //extinction coefficient for direct radiation
-                _kpb_[i] = _kdr_bl_[i]*std::sqrt(1-_zeta);
-
-                _diffusePar_[i] = _ec * (1- _rho_cd) * _rgHourly_diff_[i] * (1-std::exp(-(_kpd*_lai)));
-                _directPar_[i] = _ec * (1- _rho_cb_[i]) * _rgHourly_dir_[i] * (1-std::exp(-(_kpb_[i]*_lai)));
-                _interc_[i] = _diffusePar_[i] + _directPar_[i];
-                _Linterc = _Linterc + _interc_[i];
-            }
+            _Linterc = absorbed(*day, _kpd, _lai, _Linterc);
             _interc = _interc + _Linterc;
         }
     }
 
-
-    //functions
-    void compute_HourlyRg() {
-        _declination = 23.45 * std::sin((2*_pi*(_doy+284))/366)*_pi/180;
-        if(_latitudeRad+_declination < _pi/2 && _latitudeRad-_declination < _pi/2) { //normal day
-            _ahs = std::acos(-std::tan(_latitudeRad)*std::tan(_declination));
-            _sunrise = 12 - _ahs*12/_pi;
-            _sunset = 12 + _ahs*12/_pi;
-        } else if(_latitudeRad+_declination >= _pi/2) { //midnight sun
-            _ahs = _pi;
-            _sunrise = 0;
-            _sunset = 24;
-        } else if(_latitudeRad-_declination >= _pi/2) { //perpetual night
-            _ahs = _pi;
-            _sunrise = 12;
-            _sunset = 12;
-        }
-        _dayDuration = _sunset - _sunrise;
-        _mean = _sunrise + (_sunset-_sunrise)/2;
-        _sigma = 0.15 * (_sunset-_sunrise);
-
-        double p[24]={};
-        for(int i=0; i<24; ++i) {
-            double x = ((i+1)-_mean)/_sigma;
-            if(x < 5) {
-                p[i] = 1/std::sqrt(2*_pi)*std::exp(-0.5*x*x)/_sigma;
-            } else if(x > std::sqrt(-2*std::log(2)*-1073)) {
-                p[i] = 0;
-            } else {
-                double x1 = std::ldexp(std::ldexp(x,16),-16);
-                double x2 = x-x1;
-                p[i] = 1/std::sqrt(2*_pi) / _sigma * (std::exp(-0.5 * x1 * x1) * std::exp((-0.5*x2-x1)*x2));
-            }
-        }
-
-        for(int i=0;i<24;i++) {
-            _rgHourly_[i] = (p[i]*_Rg);
-            _sinBeta_[i] = std::max(0.0,std::sin(_latitudeRad)*std::sin(_declination)+std::cos(_latitudeRad)*std::cos(_declination)*cos(2*_pi*(i+12)/24));
-            _rgHourly_diff_[i] = _propRgRd * _rgHourly_[i];
-            _rgHourly_dir_[i] = _rgHourly_[i] - _rgHourly_diff_[i];
-        }
-    }
-
-    void compute_diff_dir() {
-        if (_TransAtm <= 0.07){
-            _propRgRd = 1;
-        } else if ((_TransAtm > 0.07) && (_TransAtm <= 0.35))  {
-            _propRgRd = 1 - 2.3*std::pow(_TransAtm-0.07,2);
-        } else if ((_TransAtm > 0.35) && (_TransAtm <= 0.75)) {
-            _propRgRd = 1.33 - 1.46*_TransAtm;
-        } else {
-            _propRgRd = 0.23;
-        }
-        for(int i=0;i<24;i++) {
-            _rgHourly_diff_[i] = _propRgRd * _rgHourly_[i];
-            _rgHourly_dir_[i] = _rgHourly_[i] - _rgHourly_diff_[i];
-        }
+    //diffuse and direct PAR absorbed over the hours of day by a layer of
+    //LAI lai, added to sum hour after hour; direct PAR is null outside
+    //[dawn, dusk). One loop per part of the day, none with a branch: at -O2
+    //(R puts its own after the -Ofast of Makevars) they are scalar, with
+    //fast math they are vectorized with glibc's vector exp
+    static double absorbed(const SolarDay& day, double kpd, double lai, double sum) {
+        double diffuse = 1-std::exp(-(kpd*lai));
+        int i = 0;
+        for(; i<day.dawn; ++i)
+            sum = sum + day.diffuse[i] * diffuse;
+        for(; i<day.dusk; ++i)
+            sum = sum + (day.diffuse[i] * diffuse + day.direct[i] * (1-std::exp(-(day.kpb[i]*lai))));
+        for(; i<24; ++i)
+            sum = sum + day.diffuse[i] * diffuse;
+        return sum;
     }
 
-    double compute_kd(double elevation) {
-        double oav = 0;
-        if(elevation>=(_leafAngle*_pi/180)) {
-            oav = std::sin(elevation)*std::sin(_leafAngle*_pi/180);
-        } else {
-            oav = 2*((std::sin(elevation)*std::cos(_leafAngle*_pi/180) * std::asin(std::tan(elevation)/std::tan(_leafAngle*_pi/180)))+(std::sqrt(std::pow(std::sin(_leafAngle*_pi/180),2) - std::pow(std::sin(elevation),2))))/_pi;
-        }
-        if(sin(elevation) != 0) {
-            return(oav/std::sin(elevation));
-        } else {
-            return(0);
-        }
-    }
-
-
     void init(double t, const ecomeristem::ModelParameters& parameters) {
         last_time = t-1;
 
         //parameters
-        _parameters = parameters;
-        _density = parameters.get("density");
-        _ec = 0.48;
-        _latitudeRad = 43.6167 * 3.141592653589793238462643383280/180;
-        _pi = 3.141592653589793238462643383280;
-        _zeta = 0.2;
-        _leafAngle = 50;
-        _rho_cd = 0.057;
+        _parameters = &parameters;
+        _density = parameters.get(parameter::density);
         _nbLayers = 1;
+        _table = SolarTable::get(parameters);
+        _kd_15 = _site.compute_kd((15*_site.pi)/180);
+        _kd_45 = _site.compute_kd((45*_site.pi)/180);
+        _kd_75 = _site.compute_kd((75*_site.pi)/180);
 
         //  computed variables (internal)
         _Rg = 0;
@@ -259,21 +365,19 @@ public:
     }
 
 private:
-    ecomeristem::ModelParameters _parameters;
+    const ecomeristem::ModelParameters * _parameters;
+    std::shared_ptr < const SolarTable > _table;
+    SolarDay _day;
 
     //  parameters
-    double _ec;
-    double _latitudeRad;
-    double _pi;
-    double _zeta;
-    double _leafAngle;
+    SolarSite _site;
     double _density;
     double _nbLayers;
-    double _rho_cd;
+    double _kd_15;
+    double _kd_45;
+    double _kd_75;
 
     //  parameters(t)
-    double _radiation;
-    double _Ta;
     double _doy;
 
     //  internals - computed
@@ -286,18 +390,6 @@ private:
     double _mean;
     double _sigma;
 
-    double _rgHourly_[24];
-    double _sinBeta_[24];
-    double _elevation_[24];
-    double _rgHourly_diff_[24];
-    double _rgHourly_dir_[24];
-    double _kdr_bl_[24];
-    double _rho_cb_[24];
-    double _kpb_[24];
-    double _diffusePar_[24];
-    double _directPar_[24];
-    double _interc_[24];
-
     double _scd;
     double _sinLD;
     double _cosLD;
@@ -78,7 +78,7 @@ public:
 
     void compute_IC(double t)
     {
-        if (t != _parameters.beginDate) {
+        if (t != _parameters->beginDate) {
             double resDiv, mean;
             double total = 0.;
             int n = 0;
@@ -195,12 +195,12 @@ public:
         last_time = t-1;
 
         // parameters
-        _parameters = parameters;
+        _parameters = &parameters;
 
         //    parameters variables
-        _gdw = _parameters.get("gdw");
-        _leaf_stock_max = parameters.get("leaf_stock_max");
-        _realocationCoeff = _parameters.get("realocationCoeff");
+        _gdw = _parameters->get(parameter::gdw);
+        _leaf_stock_max = parameters.get(parameter::leaf_stock_max);
+        _realocationCoeff = _parameters->get(parameter::realocationCoeff);
 
         //    computed variables (internal)
         _day_demand = 0;
@@ -220,7 +220,7 @@ public:
     }
 
 private:
-    ecomeristem::ModelParameters _parameters;
+    const ecomeristem::ModelParameters * _parameters;
     //    parameters
     double _gdw;
     double _leaf_stock_max;
@@ -127,11 +127,11 @@ public:
 
 
     void init(double t, const ecomeristem::ModelParameters& parameters) {
-        _parameters = parameters;
+        _parameters = &parameters;
         //    paramaters variables
-        _plasto_init = _parameters.get("plasto_init");
-        _phyllo_init = _parameters.get("phyllo_init");
-        _ligulo_init = _parameters.get("ligulo_init");
+        _plasto_init = _parameters->get(parameter::plasto_init);
+        _phyllo_init = _parameters->get(parameter::phyllo_init);
+        _ligulo_init = _parameters->get(parameter::ligulo_init);
 
 
         //    computed variables
@@ -166,7 +166,7 @@ public:
     }
 
 private:
-    ecomeristem::ModelParameters _parameters;
+    const ecomeristem::ModelParameters * _parameters;
     //    parameters
     double _plasto_init;
     double _phyllo_init;
@@ -62,11 +62,11 @@ public:
 
     void compute(double t, bool /* update */) {
         //parameters
-        _etp = _parameters.get(t).Etp;
+        _etp = _parameters->get(t).Etp;
         // _etp = computeETP();
-        _water_supply = _parameters.get(t).Irrigation;
+        _water_supply = _parameters->get(t).Irrigation;
         if(wbmodel == 1) {
-            if(t -_parameters.beginDate > 5) {
+            if(t -_parameters->beginDate > 5) {
                 //Pot Waterbalance model [phenoarch 2017]
 
                 //FTSW
@@ -99,7 +99,7 @@ public:
                 _De = std::min(TEW,std::max(0.0,_De + _evaporation + (_transpiration/coeff_evaplayer) - std::min(TEW,(_water_supply/coeff_evaplayer))));
             }
         } else {
-            _water_supply = _parameters.get(t).Irrigation;
+            _water_supply = _parameters->get(t).Irrigation;
 
             //Field waterbalance model [BFF 2014-2015-2016]
             _cstr = 1;
@@ -178,28 +178,28 @@ public:
 
 
     void init(double /*t*/, const ecomeristem::ModelParameters& parameters) {
-        _parameters = parameters;
+        _parameters = &parameters;
 
         //    paramaters variables
-        ThresTransp = parameters.get("thresTransp");
-        RU1 = parameters.get("RU1");
-        ETPmax = parameters.get("ETPmax");
-        Kcpot = parameters.get("Kcpot");
-        Density = parameters.get("density");
-        thresLER = parameters.get("thresLER");
-        thresINER = parameters.get("thresINER");
-        thresAssim = parameters.get("thresAssim");
-        thresLEN = parameters.get("thresLEN");
-        stressBP = parameters.get("stressBP");
-        stressBP2 = parameters.get("stressBP2");
-        pot = parameters.get("psib");
-        pf = parameters.get("pf");;
-        swc_init = parameters.get("swc_init");
-        wbmodel = parameters.get("wbmodel");
-        TEW = parameters.get("TEW");
-        REW = parameters.get("REW");
-        Ke_init = parameters.get("Ke_init");
-        coeff_evaplayer = parameters.get("coeff_evaplayer");
+        ThresTransp = parameters.get(parameter::thresTransp);
+        RU1 = parameters.get(parameter::RU1);
+        ETPmax = parameters.get(parameter::ETPmax);
+        Kcpot = parameters.get(parameter::Kcpot);
+        Density = parameters.get(parameter::density);
+        thresLER = parameters.get(parameter::thresLER);
+        thresINER = parameters.get(parameter::thresINER);
+        thresAssim = parameters.get(parameter::thresAssim);
+        thresLEN = parameters.get(parameter::thresLEN);
+        stressBP = parameters.get(parameter::stressBP);
+        stressBP2 = parameters.get(parameter::stressBP2);
+        pot = parameters.get(parameter::psib);
+        pf = parameters.get(parameter::pf);;
+        swc_init = parameters.get(parameter::swc_init);
+        wbmodel = parameters.get(parameter::wbmodel);
+        TEW = parameters.get(parameter::TEW);
+        REW = parameters.get(parameter::REW);
+        Ke_init = parameters.get(parameter::Ke_init);
+        coeff_evaplayer = parameters.get(parameter::coeff_evaplayer);
 
         //    computed variables
         _cstr = 1;
@@ -220,7 +220,7 @@ public:
     }
 
 private:
-    ecomeristem::ModelParameters _parameters;
+    const ecomeristem::ModelParameters * _parameters;
     // parameters
     double ETPmax;
     double Kcpot;
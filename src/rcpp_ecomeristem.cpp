@@ -1,5 +1,10 @@
 #include <Rcpp.h>
 #include <Rinternals.h>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <fstream>
+#include <sstream>
 
 #include "recomeristem_types.hpp"
 
@@ -21,6 +26,19 @@ DataFrame mapOfVectorToDF(std::map<std::string, std::vector<double>> map) {
   return df;
 }
 
+DataFrame viewToDF(const View& view) {
+  Rcpp::CharacterVector names;
+  List values(view.columns());
+  for (size_t k = 0; k < view.columns(); ++k) {
+    names.push_back(view.name(k));
+    NumericVector vec( view.column(k), view.column(k) + view.size() );
+    values[k] = vec;
+  }
+  DataFrame df(values);
+  df.attr("names") = names;
+  return df;
+}
+
 map <string, vector <double > > mapFromDF(DataFrame list) {
   map <string, vector <double > > map;
   CharacterVector names = list.attr("names");
@@ -33,14 +51,24 @@ map <string, vector <double > > mapFromDF(DataFrame list) {
 }
 
 
+//environment of the cache at folder, see utils/environmentcache.h
+utils::EnvironmentCache::Environment get_environment(const std::string & caller,
+                                                     const std::string & folder) {
+  utils::EnvironmentCache::Environment environment = utils::EnvironmentCache::instance().get(folder);
+  if (!environment) {
+    Rcpp::stop(caller + ": " + folder + " is neither a folder nor a valid environment file");
+  }
+  return environment;
+}
+
+//folder can also be a binary environment file, see convert_environment;
+//environments are cached, see utils/environmentcache.h
 // [[Rcpp::export]]
 List getParameters_from_files(Rcpp::String folder)
 {
-  ecomeristem::ModelParameters parameters;
-  utils::ParametersReader reader;
-  reader.loadParametersFromFiles(folder, parameters);
+  utils::EnvironmentCache::Environment environment = get_environment("getParameters_from_files", folder);
 
-  std::map < std::string, double > * paramMap = parameters.getRawParameters();
+  const std::map < std::string, double > * paramMap = environment->getRawParameters();
   Rcpp::List result(paramMap->size());
   Rcpp::CharacterVector names;
   Rcpp::NumericVector values;
@@ -56,14 +84,13 @@ List getParameters_from_files(Rcpp::String folder)
 }
 
 
+//folder can also be a binary environment file
 // [[Rcpp::export]]
 List getMeteo_from_files(Rcpp::String folder)
 {
-  ecomeristem::ModelParameters parameters;
-  utils::ParametersReader reader;
-  reader.loadParametersFromFiles(folder, parameters);
+  utils::EnvironmentCache::Environment environment = get_environment("getMeteo_from_files", folder);
 
-  std::vector < ecomeristem::Climate > * meteoValues = parameters.getMeteoValues();
+  const std::vector < ecomeristem::Climate > * meteoValues = &environment->meteo();
   Rcpp::List result(meteoValues->size());
   CharacterVector names =  CharacterVector::create("Temperature", "Par", "Etp", "Irrigation", "P");
   NumericVector Temperature, Par, Etp, Irrigation, P;
@@ -86,22 +113,57 @@ List getMeteo_from_files(Rcpp::String folder)
   return df;
 }
 
+//drops folder from the environment cache, every environment if empty: the
+//next call loads it again even if its files look unchanged
+// [[Rcpp::export]]
+void clear_environment_cache(Rcpp::String folder = "") {
+  std::string path = folder;
+  if (path.empty()) {
+    utils::EnvironmentCache::instance().clear();
+  } else {
+    utils::EnvironmentCache::instance().clear(path);
+  }
+}
+
 
 struct Simulation {
-  Simulation(){}
+  Simulation() : simulator(new PlantModel(), globalParameters) {}
   GlobalParameters globalParameters;
   ecomeristem::ModelParameters parameters;
   double beginDate;
   double endDate;
   EcomeristemContext context;
   SimulatorFilter filter;
+  map <string, vector <double > > obs;
+  Objective objective;
+  //kept between launches: init resets the plant and reuses its organs storage
+  EcomeristemSimulator simulator;
 };
 
 
 std::map <std::string, Simulation*> simulations;
 
+//resolves the parameters of a new simulation and compiles its obs; its
+//meteo is shared with the batch copies of the parameters and the tables
+//derived from it, see model::SolarTable
+void start_simu(Simulation * s, List obs) {
+  s->parameters.shareMeteo();
+  s->parameters.resolve();
+  s->parameters.beginDate = s->parameters.get("BeginDate");
+  /** RUN SIMU **/
+  s->beginDate = s->parameters.get("BeginDate");
+  s->endDate = s->parameters.get("EndDate");
+  s->context.setBegin(s->beginDate);
+  s->context.setEnd(s->endDate);
+
+  observer::PlantView view;
+  s->obs = mapFromDF(obs);
+  s->filter.init(&view, s->obs, "day");
+}
+
 // [[Rcpp::export]]
 void init_simu(List dfParameters, List dfMeteo, List obs, Rcpp::String name) {
+  delete simulations[name];
   Simulation * s = new Simulation();
   simulations[name] = s;
   CharacterVector names = dfParameters[0];
@@ -126,16 +188,27 @@ void init_simu(List dfParameters, List dfMeteo, List obs, Rcpp::String name) {
     s->parameters.meteoValues.push_back(c);
   }
 
-  s->parameters.beginDate = s->parameters.get("BeginDate");
-  /** RUN SIMU **/
-  s->beginDate = s->parameters.get("BeginDate");
-  s->endDate = s->parameters.get("EndDate");
-  s->context.setBegin(s->beginDate);
-  s->context.setEnd(s->endDate);
+  start_simu(s, obs);
+}
 
-  observer::PlantView view;
-  map <string, vector <double > > obsMap = mapFromDF(obs);
-  s->filter.init(&view, obsMap, "day");
+//init_simu on an environment of the cache, see getParameters_from_files:
+//the simulation shares its meteo rather than copying it. dfParameters, in
+//the layout of init_simu, overrides some of its parameters
+// [[Rcpp::export]]
+void init_simu_environment(Rcpp::String folder, List obs, Rcpp::String name, List dfParameters = List()) {
+  utils::EnvironmentCache::Environment environment = get_environment("init_simu_environment", folder);
+  delete simulations[name];
+  Simulation * s = new Simulation();
+  simulations[name] = s;
+  s->parameters = *environment;
+  if (dfParameters.size() > 0) {
+    CharacterVector names = dfParameters[0];
+    NumericVector values = dfParameters[1];
+    for (int i = 0; i < names.size(); ++i) {
+      s->parameters.set(Rcpp::as<std::string>(names(i)), values(i));
+    }
+  }
+  start_simu(s, obs);
 }
 
 // [[Rcpp::export]]
@@ -143,15 +216,749 @@ List launch_simu(Rcpp::String name, CharacterVector names = CharacterVector(), N
   Simulation * s = simulations[name];
   if(names.size() > 0) {
     for (int i = 0; i < names.size(); ++i) {
-      s->parameters.mParams[Rcpp::as<string>(names(i))] = params[i];
+      s->parameters.set(Rcpp::as<string>(names(i)), params[i]);
     }
   }
-  EcomeristemSimulator simulator(new PlantModel(), s->globalParameters);
-  simulator.init(s->beginDate, s->parameters);
-  map<string,vector<double>> res = simulator.runOptim(s->context, s->filter);
+  s->simulator.init(s->beginDate, s->parameters);
+  map<string,vector<double>> res = s->simulator.runOptim(s->context, s->filter);
   return mapOfVectorToDF(res);
 }
 
+//computes the culms of each step of the launches of simulation name on
+//nthreads threads, 1 to compute them in turn; results are the same either
+//way. Batch runs still use one thread per simulator
+// [[Rcpp::export]]
+void set_culm_threads(Rcpp::String name, int nthreads) {
+  simulations[name]->simulator.model()->setCulmThreads(nthreads > 1 ? nthreads : 1);
+}
+
+//heap allocations of the organs storage of simulation name since init_simu
+//and organs it holds: launches after the first one shouldn't allocate
+// [[Rcpp::export]]
+NumericVector get_arena_counts(Rcpp::String name) {
+  const SimpleArena & arena = simulations[name]->simulator.arena();
+  NumericVector counts = NumericVector::create((double)arena.allocations(), (double)arena.objects());
+  counts.attr("names") = CharacterVector::create("allocations", "objects");
+  return counts;
+}
+
+//scores the next launch_simu_objective calls against the obs given to
+//init_simu; weights columns are named like the obs ones
+// [[Rcpp::export]]
+void init_objective(Rcpp::String name, List obsET, double penalty, List weights = List()) {
+  Simulation * s = simulations[name];
+  map <string, vector <double > > w;
+  if (weights.size() > 0) {
+    w = mapFromDF(weights);
+  }
+  s->objective.init(s->obs, mapFromDF(obsET), w, penalty);
+}
+
+//score of a run of simulator, abandoned as soon as it is known to exceed
+//threshold: pruned is then set and the score returned is that lower bound
+double run_objective(Simulation * s, EcomeristemSimulator & simulator,
+                     const ecomeristem::ModelParameters & parameters, double threshold,
+                     bool & pruned, std::vector<double> * components = nullptr) {
+  simulator.init(s->beginDate, parameters);
+  EcomeristemSimulator::Stop stop;
+  Objective::Partial partial;
+  double bound = 0;
+  if (!is_inf(threshold) && !is_na(threshold)) {
+    s->objective.start(partial);
+    stop = [&](const map<string,vector<double>>& results, size_t rows) {
+      bound = s->objective.bound(partial, results, rows);
+      return bound > threshold;
+    };
+  }
+  EcomeristemContext context = s->context;
+  map<string,vector<double>> res = simulator.runOptim(context, s->filter, stop, pruned);
+  double score = s->objective(res, components);
+  return pruned ? bound : score;
+}
+
+//same run as launch_simu but only returns the score, followed by the score
+//of each variable when components is true. The run is abandoned as soon as
+//the score is known to exceed threshold: the result then has a "pruned"
+//attribute set, its score is that lower bound and its components only
+//cover the days simulated
+// [[Rcpp::export]]
+NumericVector launch_simu_objective(Rcpp::String name, CharacterVector names = CharacterVector(), NumericVector params = NumericVector(), bool components = false, double threshold = R_PosInf) {
+  Simulation * s = simulations[name];
+  for (int i = 0; i < names.size(); ++i) {
+    s->parameters.set(Rcpp::as<string>(names(i)), params[i]);
+  }
+  std::vector<double> values;
+  bool pruned;
+  double score = run_objective(s, s->simulator, s->parameters, threshold, pruned,
+                               components ? &values : nullptr);
+  NumericVector ret(values.size() + 1);
+  ret[0] = score;
+  if (components) {
+    CharacterVector labels(values.size() + 1);
+    labels[0] = "objective";
+    for (size_t k = 0; k < values.size(); ++k) {
+      ret[k + 1] = values[k];
+      labels[k + 1] = s->objective.name(k);
+    }
+    ret.attr("names") = labels;
+  }
+  if (pruned) {
+    ret.attr("pruned") = true;
+  }
+  return ret;
+}
+
+//calls work on nthreads threads, 0 for all cores, at most tasks, the
+//calling thread being one of them
+template < typename F >
+void run_threads(size_t tasks, int nthreads, F work) {
+  PlantModel::bindModels();
+  size_t workers = nthreads > 0 ? nthreads : std::thread::hardware_concurrency();
+  workers = std::max<size_t>(1, std::min(workers, tasks));
+  std::vector<std::thread> pool;
+  for (size_t i = 1; i < workers; ++i) {
+    pool.push_back(std::thread(work));
+  }
+  work();
+  for (std::thread & t : pool) {
+    t.join();
+  }
+}
+
+//calls run(simulator, parameters, row) for each row on nthreads threads, 0
+//for all cores; each thread has its own simulator and copy of the
+//registered parameters, which are left untouched
+template < typename F >
+void for_each_row(Simulation * s, size_t rows, int nthreads, F run) {
+  std::atomic<size_t> next(0);
+  run_threads(rows, nthreads, [&]() {
+    ecomeristem::ModelParameters parameters = s->parameters;
+    GlobalParameters globalParameters;
+    EcomeristemSimulator simulator(new PlantModel(), globalParameters);
+    for (size_t row = next++; row < rows; row = next++) {
+      run(simulator, parameters, row);
+    }
+  });
+}
+
+//runs one simulation per row of params (one column per name) on nthreads
+//threads, 0 for all cores; the registered parameters are left untouched
+// [[Rcpp::export]]
+List launch_simu_batch(Rcpp::String name, CharacterVector names, NumericMatrix params, int nthreads = 0) {
+  if (names.size() != params.ncol()) {
+    Rcpp::stop("launch_simu_batch: params must have one column per name");
+  }
+  Simulation * s = simulations[name];
+  std::vector<std::string> keys;
+  for (int i = 0; i < names.size(); ++i) {
+    keys.push_back(Rcpp::as<string>(names(i)));
+  }
+  size_t rows = params.nrow();
+  std::vector<double> values(params.begin(), params.end());
+  std::vector<map<string,vector<double>>> results(rows);
+
+  for_each_row(s, rows, nthreads, [&](EcomeristemSimulator & simulator,
+                                      ecomeristem::ModelParameters & parameters, size_t row) {
+    for (size_t i = 0; i < keys.size(); ++i) {
+      parameters.set(keys[i], values[row + i * rows]);
+    }
+    simulator.init(s->beginDate, parameters);
+    EcomeristemContext context = s->context;
+    results[row] = simulator.runOptim(context, s->filter);
+  });
+
+  List ret(rows);
+  for (size_t row = 0; row < rows; ++row) {
+    ret[row] = mapOfVectorToDF(results[row]);
+  }
+  return ret;
+}
+
+//plasto < phyllo < ligulo, before and after PI, as checked by the
+//estimation scripts
+bool ordered_rythms(const ecomeristem::ModelParameters & p) {
+  using namespace parameter;
+  return p.get(phyllo_init) >= p.get(plasto_init)
+      && p.get(ligulo_init) >= p.get(phyllo_init)
+      && p.get(phyllo_init) * p.get(coef_phyllo_PI) >= p.get(plasto_init) * p.get(coef_plasto_PI)
+      && p.get(ligulo_init) * p.get(coef_ligulo_PI) >= p.get(phyllo_init) * p.get(coef_phyllo_PI);
+}
+
+//DEoptim-like calibration of paramNames within [lower, upper] against the
+//objective set by init_objective. control may hold NP, itermax, F, CR,
+//reltol, steptol, VTR as for DEoptim (strategy 2 only), plus seed, nthreads
+//and constraints: when true (default) and the three plasto, phyllo and
+//ligulo init values are calibrated, unordered candidates score 99999.
+//A seed gives the same result whatever the number of threads.
+// [[Rcpp::export]]
+List optim_de(Rcpp::String name, CharacterVector paramNames, NumericVector lower, NumericVector upper, List control = List()) {
+  Simulation * s = simulations[name];
+  if (s->objective.empty()) {
+    Rcpp::stop("optim_de: init_objective must be called first");
+  }
+  std::vector<std::string> keys;
+  for (int i = 0; i < paramNames.size(); ++i) {
+    keys.push_back(Rcpp::as<string>(paramNames(i)));
+  }
+
+  DifferentialEvolution::Control c;
+  int nthreads = 0;
+  bool constraints = true;
+  if (control.containsElementNamed("NP")) c.NP = as<int>(control["NP"]);
+  if (control.containsElementNamed("itermax")) c.itermax = as<int>(control["itermax"]);
+  if (control.containsElementNamed("F")) c.F = as<double>(control["F"]);
+  if (control.containsElementNamed("CR")) c.CR = as<double>(control["CR"]);
+  if (control.containsElementNamed("reltol")) c.reltol = as<double>(control["reltol"]);
+  if (control.containsElementNamed("steptol")) c.steptol = as<int>(control["steptol"]);
+  if (control.containsElementNamed("VTR")) c.VTR = as<double>(control["VTR"]);
+  if (control.containsElementNamed("seed")) c.seed = as<double>(control["seed"]);
+  if (control.containsElementNamed("nthreads")) nthreads = as<int>(control["nthreads"]);
+  if (control.containsElementNamed("constraints")) constraints = as<bool>(control["constraints"]);
+  if (control.containsElementNamed("strategy") && as<int>(control["strategy"]) != 2) {
+    Rcpp::stop("optim_de: only strategy 2 is available");
+  }
+  //checks and defaults of DEoptim and DEoptim.control
+  if (lower.size() != upper.size()) {
+    Rcpp::stop("optim_de: 'lower' and 'upper' are not of same length");
+  }
+  if (paramNames.size() != lower.size()) {
+    Rcpp::stop("optim_de: 'paramNames' and 'lower' are not of same length");
+  }
+  for (int i = 0; i < lower.size(); ++i) {
+    if (is_na(lower[i]) || is_na(upper[i])) {
+      Rcpp::stop("optim_de: 'lower' and 'upper' can't be NA");
+    }
+    if (lower[i] > upper[i]) {
+      Rcpp::stop("optim_de: 'lower' > 'upper'");
+    }
+  }
+  if (control.containsElementNamed("NP") && as<int>(control["NP"]) < 4) {
+    Rcpp::warning("optim_de: 'NP' < 4; set to default value 50");
+    c.NP = 50;
+  }
+  if (control.containsElementNamed("itermax") && as<int>(control["itermax"]) <= 0) {
+    Rcpp::warning("optim_de: 'itermax' <= 0; set to default value 200");
+    c.itermax = 200;
+  }
+  if (!(c.F >= 0 && c.F <= 2)) {
+    Rcpp::warning("optim_de: 'F' not in [0,2]; set to default value 0.8");
+    c.F = 0.8;
+  }
+  if (!(c.CR >= 0 && c.CR <= 1)) {
+    Rcpp::warning("optim_de: 'CR' not in [0,1]; set to default value 0.5");
+    c.CR = 0.5;
+  }
+  constraints = constraints
+      && std::find(keys.begin(), keys.end(), "phyllo_init") != keys.end()
+      && std::find(keys.begin(), keys.end(), "plasto_init") != keys.end()
+      && std::find(keys.begin(), keys.end(), "ligulo_init") != keys.end();
+
+  //a trial is only kept if it beats its target, so it can be abandoned as
+  //soon as its score is known to exceed the target's one
+  DifferentialEvolution de;
+  DifferentialEvolution::Result result = de.minimize(
+      std::vector<double>(lower.begin(), lower.end()),
+      std::vector<double>(upper.begin(), upper.end()), c,
+      [&](const std::vector<std::vector<double>>& candidates,
+          const std::vector<double>& thresholds, std::vector<double>& values) {
+        for_each_row(s, candidates.size(), nthreads, [&](EcomeristemSimulator & simulator,
+                                                        ecomeristem::ModelParameters & parameters, size_t row) {
+          for (size_t i = 0; i < keys.size(); ++i) {
+            parameters.set(keys[i], candidates[row][i]);
+          }
+          if (constraints && !ordered_rythms(parameters)) {
+            values[row] = 99999;
+            return;
+          }
+          bool pruned;
+          values[row] = run_objective(s, simulator, parameters, thresholds[row], pruned);
+        });
+      });
+
+  NumericVector bestmem(result.bestmem.begin(), result.bestmem.end());
+  bestmem.attr("names") = paramNames;
+  return List::create(Named("bestmem") = bestmem,
+                      Named("bestval") = result.bestval,
+                      Named("iter") = result.iter,
+                      Named("nfeval") = (double)result.nfeval);
+}
+
+struct Group {
+  std::vector<std::string> members;
+  std::vector<double> weights;
+};
+
+std::map <std::string, Group> groups;
+
+//registers simulations evaluated together by launch_group_objective, each
+//one with its own meteo, obs and objective; weights default to 1
+// [[Rcpp::export]]
+void init_group(Rcpp::String name, CharacterVector members, NumericVector weights = NumericVector()) {
+  Group g;
+  for (int i = 0; i < members.size(); ++i) {
+    std::string member = Rcpp::as<string>(members(i));
+    if (simulations.find(member) == simulations.end()) {
+      Rcpp::stop("init_group: unknown simulation " + member);
+    }
+    //members run concurrently on their own simulator
+    if (std::find(g.members.begin(), g.members.end(), member) != g.members.end()) {
+      Rcpp::stop("init_group: " + member + " is given twice");
+    }
+    g.members.push_back(member);
+    g.weights.push_back(i < weights.size() ? weights[i] : 1.);
+  }
+  groups[name] = g;
+}
+
+//sets the parameters of every simulation of the group, runs them at once on
+//nthreads threads (0 for all cores) and returns the weighted sum of their
+//objectives, followed by each of them when components is true
+// [[Rcpp::export]]
+NumericVector launch_group_objective(Rcpp::String name, CharacterVector names = CharacterVector(), NumericVector params = NumericVector(), bool components = false, int nthreads = 0) {
+  std::map <std::string, Group>::const_iterator group = groups.find(name);
+  if (group == groups.end()) {
+    Rcpp::stop("launch_group_objective: unknown group " + std::string(name));
+  }
+  const Group & g = group->second;
+  std::vector<Simulation *> members;
+  for (const std::string & member : g.members) {
+    Simulation * s = simulations[member];
+    if (s->objective.empty()) {
+      Rcpp::stop("launch_group_objective: init_objective must be called first for " + member);
+    }
+    members.push_back(s);
+  }
+  for (Simulation * s : members) {
+    for (int i = 0; i < names.size(); ++i) {
+      s->parameters.set(Rcpp::as<string>(names(i)), params[i]);
+    }
+  }
+
+  std::vector<double> scores(members.size());
+  std::atomic<size_t> next(0);
+  run_threads(members.size(), nthreads, [&]() {
+    for (size_t i = next++; i < members.size(); i = next++) {
+      bool pruned;
+      scores[i] = run_objective(members[i], members[i]->simulator, members[i]->parameters, R_PosInf, pruned);
+    }
+  });
+
+  double score = 0;
+  for (size_t i = 0; i < scores.size(); ++i) {
+    score += g.weights[i] * scores[i];
+  }
+  if (!components) {
+    return NumericVector::create(score);
+  }
+  NumericVector ret(scores.size() + 1);
+  CharacterVector labels(scores.size() + 1);
+  ret[0] = score;
+  labels[0] = "objective";
+  for (size_t i = 0; i < scores.size(); ++i) {
+    ret[i + 1] = scores[i];
+    labels[i + 1] = g.members[i];
+  }
+  ret.attr("names") = labels;
+  return ret;
+}
+
+//fast99 needs n > 4 M^2 points per factor for its frequencies, as in the
+//sensitivity package
+void check_fast(const std::string & caller, int n, int M) {
+  if (M < 1) {
+    Rcpp::stop(caller + ": M must be at least 1");
+  }
+  if (n <= 4 * M * M) {
+    Rcpp::stop(caller + ": fast needs n > 4 * M^2 points per factor");
+  }
+}
+
+//sensitivity design of method "morris", "fast" or "sobol", one row per run
+//and one column per factor within [lower, upper]. control may hold r, levels
+//and jump (morris), n and M (fast), N (sobol) and seed
+// [[Rcpp::export]]
+NumericMatrix sa_design(Rcpp::String method, NumericVector lower, NumericVector upper, List control = List()) {
+  if (lower.size() == 0 || lower.size() != upper.size()) {
+    Rcpp::stop("sa_design: lower and upper must have one value per factor");
+  }
+  for (int i = 0; i < lower.size(); ++i) {
+    if (!(lower[i] <= upper[i])) {
+      Rcpp::stop("sa_design: lower must not exceed upper");
+    }
+  }
+  std::vector<double> lo(lower.begin(), lower.end());
+  std::vector<double> up(upper.begin(), upper.end());
+  unsigned long seed = control.containsElementNamed("seed") ? as<double>(control["seed"]) : 0;
+  std::string m = method;
+  sensitivity::Design X;
+  if (m == "morris") {
+    int r = control.containsElementNamed("r") ? as<int>(control["r"]) : 100;
+    int levels = control.containsElementNamed("levels") ? as<int>(control["levels"]) : 10;
+    int jump = control.containsElementNamed("jump") ? as<int>(control["jump"]) : 5;
+    if (r < 1) {
+      Rcpp::stop("sa_design: r must be at least 1");
+    }
+    if (levels < 2 || jump < 1 || jump >= levels) {
+      Rcpp::stop("sa_design: morris needs levels >= 2 and 1 <= jump < levels");
+    }
+    X = sensitivity::morris(lo, up, r, levels, jump, seed);
+  } else if (m == "fast") {
+    int n = control.containsElementNamed("n") ? as<int>(control["n"]) : 1000;
+    int M = control.containsElementNamed("M") ? as<int>(control["M"]) : 4;
+    check_fast("sa_design", n, M);
+    X = sensitivity::fast(lo, up, n, M);
+  } else if (m == "sobol") {
+    int N = control.containsElementNamed("N") ? as<int>(control["N"]) : 1000;
+    if (N < 1) {
+      Rcpp::stop("sa_design: N must be at least 1");
+    }
+    X = sensitivity::sobol(lo, up, N, seed);
+  } else {
+    Rcpp::stop("sa_design: unknown method " + m);
+  }
+  NumericMatrix ret(X.size(), lo.size());
+  for (size_t i = 0; i < X.size(); ++i) {
+    for (size_t j = 0; j < lo.size(); ++j) {
+      ret(i, j) = X[i][j];
+    }
+  }
+  return ret;
+}
+
+//outputs of a run of the registered simulation: every obs variable at
+//every obs day, named <variable>_<day>
+std::vector<std::string> output_columns(Simulation * s) {
+  std::vector<std::string> columns;
+  for (const std::string & n : s->filter.names) {
+    for (double d : s->filter.days) {
+      std::ostringstream column;
+      column << n << "_" << d;
+      columns.push_back(column.str());
+    }
+  }
+  return columns;
+}
+
+//writes the outputs of a run, in output_columns order, as tab separated
+//text (NA for NaN) or as native doubles
+void write_outputs(std::ostream & out, Simulation * s,
+                   const map<string,vector<double>> & results, bool binary = false) {
+  for (const std::string & v : s->filter.names) {
+    for (double value : results.at(v)) {
+      if (binary) {
+        out.write(reinterpret_cast<const char *>(&value), sizeof(double));
+      } else if (is_na(value)) {
+        out << "\tNA";
+      } else {
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), "\t%.17g", value);
+        out << buffer;
+      }
+    }
+  }
+}
+
+//FNV-1a hash of the size and values of a design X (column-major), written
+//in hex by sa_run so that its files are only read back with the same X
+std::string design_hash(const std::vector<double> & X, size_t rows) {
+  uint64_t hash = 14695981039346656037ULL;
+  auto add = [&hash](const void * data, size_t size) {
+    const unsigned char * bytes = static_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < size; ++i) {
+      hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+  };
+  uint64_t size[2] = { rows, rows > 0 ? X.size() / rows : 0 };
+  add(size, sizeof(size));
+  add(X.data(), X.size() * sizeof(double));
+  char buffer[17];
+  snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(hash));
+  return buffer;
+}
+
+//second line of the files of sa_run: the hash of the design and its keys
+std::string design_line(const std::vector<std::string> & keys,
+                        const std::vector<double> & X, size_t rows) {
+  std::string line = "#design\t" + design_hash(X, rows);
+  for (const std::string & key : keys) {
+    line += "\t" + key;
+  }
+  return line;
+}
+
+//appends to path the outputs of the rows of X (column-major, one column per
+//key) not there yet, chunk rows at a time; returns the rows in path. path
+//starts with the output names and the design line, a file written for
+//another design or other outputs is not resumed
+size_t run_design(Simulation * s, const std::vector<std::string> & keys,
+                  const std::vector<double> & X, size_t rows, const std::string & path,
+                  int nthreads, size_t chunk) {
+  std::string header = "row";
+  for (const std::string & column : output_columns(s)) {
+    header += "\t" + column;
+  }
+  header += "\n" + design_line(keys, X, rows) + "\n";
+
+  //complete lines of a previous run are kept, a truncated last one dropped
+  size_t done = 0;
+  std::string content;
+  std::ifstream in(path);
+  if (in) {
+    content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    in.close();
+    size_t last = content.rfind('\n');
+    content.erase(last == std::string::npos ? 0 : last + 1);
+  }
+  if (content.empty()) {
+    content = header;
+  } else if (content.compare(0, header.size(), header) != 0) {
+    Rcpp::stop("sa_run: " + path + " was written for another design or other outputs");
+  }
+  //rows are written in order from 0
+  for (size_t line = header.size(); line < content.size(); line = content.find('\n', line) + 1) {
+    if (strtoul(content.c_str() + line, nullptr, 10) != done || done >= rows) {
+      Rcpp::stop("sa_run: " + path + " does not hold the rows of the design in order");
+    }
+    ++done;
+  }
+  std::ofstream rewrite(path);
+  rewrite.write(content.data(), content.size());
+  rewrite.close();
+  std::ofstream out(path, std::ios::app);
+  if (!rewrite || !out) {
+    Rcpp::stop("sa_run: can't write " + path);
+  }
+  while (done < rows) {
+    size_t n = std::min(chunk > 0 ? chunk : rows, rows - done);
+    std::vector<map<string,vector<double>>> results(n);
+    for_each_row(s, n, nthreads, [&](EcomeristemSimulator & simulator,
+                                     ecomeristem::ModelParameters & parameters, size_t row) {
+      for (size_t i = 0; i < keys.size(); ++i) {
+        parameters.set(keys[i], X[done + row + i * rows]);
+      }
+      simulator.init(s->beginDate, parameters);
+      EcomeristemContext context = s->context;
+      results[row] = simulator.runOptim(context, s->filter);
+    });
+    for (size_t row = 0; row < n; ++row) {
+      out << done + row;
+      write_outputs(out, s, results[row]);
+      out << "\n";
+    }
+    out.flush();
+    if (!out) {
+      Rcpp::stop("sa_run: writing " + path + " failed");
+    }
+    done += n;
+  }
+  return done;
+}
+
+//runs the rows of X (one column per name) against the registered simulation
+//on nthreads threads and appends, chunk rows at a time, the value of every
+//obs variable at every obs day to file. Rows already in file are skipped:
+//calling it again with the same design resumes an interrupted run; a file
+//of another design is refused. Returns the rows in file
+// [[Rcpp::export]]
+int sa_run(Rcpp::String name, CharacterVector paramNames, NumericMatrix X, Rcpp::String file, int nthreads = 0, int chunk = 1000) {
+  if (paramNames.size() != X.ncol()) {
+    Rcpp::stop("sa_run: X must have one column per name");
+  }
+  std::vector<std::string> keys;
+  for (int i = 0; i < paramNames.size(); ++i) {
+    keys.push_back(Rcpp::as<string>(paramNames(i)));
+  }
+  std::vector<double> values(X.begin(), X.end());
+  return run_design(simulations[name], keys, values, X.nrow(), file, nthreads, chunk);
+}
+
+//outputs of the rows of the design X (column-major) written by sa_run, one
+//vector per output; path must hold each row of X once
+std::vector<std::vector<double>> read_design_outputs(const std::string & path,
+                                                     const std::vector<double> & X, size_t rows,
+                                                     std::vector<std::string> & outputs) {
+  std::ifstream in(path);
+  std::string line;
+  if (!std::getline(in, line)) {
+    Rcpp::stop("sa_indices: can't read " + path);
+  }
+  outputs = split(line, '\t');
+  outputs.erase(outputs.begin());
+  std::vector<std::string> design;
+  if (std::getline(in, line)) {
+    design = split(line, '\t');
+  }
+  if (design.size() < 2 || design[0] != "#design" || design[1] != design_hash(X, rows)) {
+    Rcpp::stop("sa_indices: " + path + " was not written by sa_run for this design");
+  }
+  std::vector<std::vector<double>> y(outputs.size(), std::vector<double>(rows, nan("")));
+  std::vector<bool> seen(rows, false);
+  while (std::getline(in, line)) {
+    std::vector<std::string> values = split(line, '\t');
+    char * end;
+    unsigned long row = strtoul(values[0].c_str(), &end, 10);
+    if (*end || row >= rows || seen[row]) {
+      Rcpp::stop("sa_indices: " + path + " holds an unknown or repeated row: " + values[0]);
+    }
+    seen[row] = true;
+    for (size_t j = 1; j < values.size() && j <= outputs.size(); ++j) {
+      double v = strtod(values[j].c_str(), &end);
+      y[j - 1][row] = *end ? nan("") : v;
+    }
+  }
+  if (std::find(seen.begin(), seen.end(), false) != seen.end()) {
+    Rcpp::stop("sa_indices: " + path + " does not hold every row of the design");
+  }
+  return y;
+}
+
+//indices of method for each output of file, written by sa_run for the design
+//X: mu, mu.star and sigma for morris, S1 and ST for fast (control may hold
+//M) and sobol
+// [[Rcpp::export]]
+List sa_indices(Rcpp::String method, NumericMatrix X, Rcpp::String file, List control = List()) {
+  size_t rows = X.nrow();
+  size_t k = X.ncol();
+  if (rows == 0 || k == 0) {
+    Rcpp::stop("sa_indices: empty design");
+  }
+  std::string m = method;
+  if (m != "morris" && m != "fast" && m != "sobol") {
+    Rcpp::stop("sa_indices: unknown method " + m);
+  }
+  //trajectories of k + 1 rows (morris), k curves (fast) or k + 2 matrices
+  //(sobol) of the same number of rows
+  size_t block = m == "morris" ? k + 1 : m == "fast" ? k : k + 2;
+  if (rows % block != 0) {
+    Rcpp::stop("sa_indices: X does not have the rows of a " + m + " design of " +
+               std::to_string(k) + " parameters");
+  }
+  std::vector<std::string> outputs;
+  std::vector<double> values(X.begin(), X.end());
+  std::vector<std::vector<double>> y = read_design_outputs(file, values, rows, outputs);
+
+  sensitivity::Design design(rows, std::vector<double>(k));
+  for (size_t i = 0; i < rows; ++i) {
+    for (size_t j = 0; j < k; ++j) {
+      design[i][j] = X(i, j);
+    }
+  }
+  List ret(outputs.size());
+  for (size_t o = 0; o < outputs.size(); ++o) {
+    std::vector<double> a, b, c;
+    if (m == "morris") {
+      sensitivity::morris_indices(design, y[o], a, b, c);
+      ret[o] = List::create(Named("mu") = NumericVector(a.begin(), a.end()),
+                            Named("mu.star") = NumericVector(b.begin(), b.end()),
+                            Named("sigma") = NumericVector(c.begin(), c.end()));
+    } else if (m == "fast") {
+      int M = control.containsElementNamed("M") ? as<int>(control["M"]) : 4;
+      check_fast("sa_indices", rows / k, M);
+      sensitivity::fast_indices(k, y[o], rows / k, M, a, b);
+      ret[o] = List::create(Named("S1") = NumericVector(a.begin(), a.end()),
+                            Named("ST") = NumericVector(b.begin(), b.end()));
+    } else {
+      sensitivity::sobol_indices(k, y[o], rows / (k + 2), a, b);
+      ret[o] = List::create(Named("S1") = NumericVector(a.begin(), a.end()),
+                            Named("ST") = NumericVector(b.begin(), b.end()));
+    }
+  }
+  CharacterVector names(outputs.begin(), outputs.end());
+  ret.attr("names") = names;
+  return ret;
+}
+
+//runs the registered simulation on the windows of series starting every
+//stride days, chunk windows at a time on nthreads threads, and writes their
+//outputs to path; returns the number of windows
+size_t run_windows(Simulation * s, const std::vector<ecomeristem::Climate> & series,
+                   size_t window, size_t stride, const std::string & path,
+                   bool binary, int nthreads, size_t chunk) {
+  if (stride == 0 || window < s->endDate - s->beginDate + 1) {
+    Rcpp::stop("launch_simu_windows: windows must cover the simulated days");
+  }
+  size_t windows = series.size() < window ? 0 : (series.size() - window) / stride + 1;
+
+  std::ofstream out(path, binary ? std::ios::binary : std::ios::out);
+  if (!out) {
+    Rcpp::stop("launch_simu_windows: can't write " + path);
+  }
+  if (!binary) {
+    out << "start";
+    for (const std::string & column : output_columns(s)) {
+      out << "\t" << column;
+    }
+    out << "\n";
+  }
+  for (size_t done = 0; done < windows; ) {
+    size_t n = std::min(chunk > 0 ? chunk : windows, windows - done);
+    std::vector<map<string,vector<double>>> results(n);
+    for_each_row(s, n, nthreads, [&](EcomeristemSimulator & simulator,
+                                     ecomeristem::ModelParameters & parameters, size_t row) {
+      std::vector<ecomeristem::Climate>::const_iterator first =
+          series.begin() + (done + row) * stride;
+      parameters.meteoValues.assign(first, first + window);
+      simulator.init(s->beginDate, parameters);
+      EcomeristemContext context = s->context;
+      results[row] = simulator.runOptim(context, s->filter);
+    });
+    for (size_t row = 0; row < n; ++row) {
+      //windows start at row 1 of the meteo data.frame, as in R
+      double start = (done + row) * stride + 1;
+      if (binary) {
+        out.write(reinterpret_cast<const char *>(&start), sizeof(double));
+      } else {
+        out << start;
+      }
+      write_outputs(out, s, results[row], binary);
+      if (!binary) {
+        out << "\n";
+      }
+    }
+    out.flush();
+    if (!out) {
+      Rcpp::stop("launch_simu_windows: writing " + path + " failed");
+    }
+    done += n;
+  }
+  out.close();
+  if (!out) {
+    Rcpp::stop("launch_simu_windows: writing " + path + " failed");
+  }
+  return windows;
+}
+
+//long series mode of launch_simu_meteo: runs the registered simulation on
+//every window of dfMeteo of window days, one starting every stride days,
+//and streams the obs variables at the obs days to file without returning
+//them. The file is tab separated with a header, or, if binary, rows of
+//native doubles readable with readBin. Returns the columns of a row: the
+//meteo row where the window starts, then <variable>_<day>
+// [[Rcpp::export]]
+CharacterVector launch_simu_windows(Rcpp::String name, List dfMeteo, int window, int stride,
+                                    Rcpp::String file, bool binary = false,
+                                    int nthreads = 0, int chunk = 1000) {
+  Simulation * s = simulations[name];
+  if (window <= 0 || stride <= 0) {
+    Rcpp::stop("launch_simu_windows: window and stride must be positive");
+  }
+  NumericVector Temperature = dfMeteo[0];
+  NumericVector Par = dfMeteo[1];
+  NumericVector Etp = dfMeteo[2];
+  NumericVector Irrigation = dfMeteo[3];
+  NumericVector P = dfMeteo[4];
+  std::vector<ecomeristem::Climate> series;
+  series.reserve(Temperature.size());
+  for (int i = 0; i < Temperature.size(); ++i) {
+    series.push_back(ecomeristem::Climate(Temperature(i), Par(i), Etp(i), Irrigation(i), P(i)));
+  }
+
+  run_windows(s, series, window, stride, file, binary, nthreads, chunk);
+  std::vector<std::string> columns = output_columns(s);
+  columns.insert(columns.begin(), "start");
+  return CharacterVector(columns.begin(), columns.end());
+}
+
 // [[Rcpp::export]]
 List launch_simu_meteo(Rcpp::String name, List dfMeteo) {
   Simulation * s = simulations[name];
@@ -166,13 +973,24 @@ List launch_simu_meteo(Rcpp::String name, List dfMeteo) {
     s->parameters.meteoValues.push_back(c);
   }
 
-  EcomeristemSimulator simulator(new PlantModel(), s->globalParameters);
-  simulator.init(s->beginDate, s->parameters);
-  map<string,vector<double>> res = simulator.runOptim(s->context, s->filter);
+  s->simulator.init(s->beginDate, s->parameters);
+  map<string,vector<double>> res = s->simulator.runOptim(s->context, s->filter);
   return mapOfVectorToDF(res);
 }
 
 
+//converts a folder of meteo and parameter text files to a binary
+//environment file, loaded without parsing by the *_from_files functions
+// [[Rcpp::export]]
+void convert_environment(Rcpp::String folder, Rcpp::String file) {
+  ecomeristem::ModelParameters parameters;
+  utils::ParametersReader reader;
+  reader.loadParametersFromFiles(folder, parameters);
+  if (!reader.saveEnvironment(file, parameters)) {
+    Rcpp::stop("convert_environment: can't write " + std::string(file));
+  }
+}
+
 // [[Rcpp::export]]
 List get_clean_obs(Rcpp::String vObsPath) {
   utils::ParametersReader reader;
@@ -182,7 +1000,7 @@ List get_clean_obs(Rcpp::String vObsPath) {
 }
 
 // [[Rcpp::export]]
-List rcpp_run_from_dataframe(List dfParameters, List dfMeteo)
+List rcpp_run_from_dataframe(List dfParameters, List dfMeteo, CharacterVector vars = CharacterVector(), int culmThreads = 1)
 {
   /** INIT PARAMS **/
   GlobalParameters globalParameters;
@@ -210,6 +1028,7 @@ List rcpp_run_from_dataframe(List dfParameters, List dfMeteo)
     parameters.meteoValues.push_back(c);
   }
 
+  parameters.resolve();
   parameters.beginDate = parameters.get("BeginDate");
   /** RUN SIMU **/
   double begin = parameters.get("BeginDate");
@@ -217,14 +1036,16 @@ List rcpp_run_from_dataframe(List dfParameters, List dfMeteo)
 
   EcomeristemSimulator * simulator = new EcomeristemSimulator(new PlantModel(), globalParameters);
   observer::PlantView *view = new observer::PlantView();
+  view->record(as<std::vector<std::string> >(vars));
   simulator->attachView("plant", view);
+  simulator->model()->setCulmThreads(culmThreads > 1 ? culmThreads : 1);
   simulator->init(begin, parameters);
   EcomeristemContext context(begin, end);
   simulator->run(context);
-  ResultParser parser;
-  std::map <std::string, std::vector<double> > resultMap = parser.resultsToMap(simulator);
+  DataFrame df = viewToDF(*view);
   delete simulator;
-  return mapOfVectorToDF(resultMap);
+  delete view;
+  return df;
 }
 
 
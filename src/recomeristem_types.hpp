@@ -24,7 +24,11 @@
 #include "defines.hpp"
 
 #include <utils/ParametersReader.hpp>
+#include <utils/environmentcache.h>
 #include <utils/resultparser.h>
+#include <utils/objective.h>
+#include <utils/differentialevolution.h>
+#include <utils/sensitivity.h>
 #include <utils/juliancalculator.h>
 #include <plant/PlantModel.hpp>
 #include <observer/PlantView.hpp>
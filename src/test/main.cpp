@@ -2,6 +2,8 @@
 #define UNSAFE_RUN
 #include <defines.hpp>
 #include <utils/ParametersReader.hpp>
+#include <utils/objective.h>
+#include <utils/resultparser.h>
 #include <plant/PlantModel.hpp>
 #include <observer/PlantView.hpp>
 
@@ -52,7 +54,204 @@ public:
 	SimulatorFilter filter;
 };
 
+//load time of a text environment folder against its binary conversion,
+//written to a temporary file rather than into the folder
+int benchEnvironment(const std::string &folder, int loads = 1000) {
+	utils::ParametersReader reader;
+	ecomeristem::ModelParameters parameters;
+	reader.loadParametersFromFiles(folder, parameters);
+#ifdef _WIN32
+	char name[L_tmpnam];
+	std::string file = std::tmpnam(name);
+#else
+	char name[] = "/tmp/environmentXXXXXX";
+	int fd = mkstemp(name);
+	if (fd < 0) {
+		cout << "can't create a temporary file\n";
+		return 1;
+	}
+	close(fd);
+	std::string file = name;
+#endif
+	reader.saveEnvironment(file, parameters);
+
+	clock_t begin_time = clock();
+	for (int i = 0; i < loads; ++i) {
+		ecomeristem::ModelParameters p;
+		reader.loadParametersFromFiles(folder, p);
+	}
+	double text = float(clock() - begin_time) / CLOCKS_PER_SEC * 1000 / loads;
+	begin_time = clock();
+	for (int i = 0; i < loads; ++i) {
+		ecomeristem::ModelParameters p;
+		reader.loadParametersFromEnvironment(file, p);
+	}
+	double binary = float(clock() - begin_time) / CLOCKS_PER_SEC * 1000 / loads;
+	std::remove(file.c_str());
+	cout << parameters.meteoValues.size() << " days: text " << text << " ms, binary "
+	     << binary << " ms per load\n";
+	return 0;
+}
+
+//NA rules of the objective, to build with the flags of Makevars (-Ofast):
+//missing obs, weights and results are skipped, missing obsET don't penalize
+int checkObjective() {
+	double na = nan("");
+	map<string, vector<double>> obs = { { "day", { 1, 2, 3 } },
+	                                     { "lai", { 2, na, 4 } },
+	                                     { "height", { 10, 20, 30 } } };
+	map<string, vector<double>> et = { { "lai", { na, 1, 1 } },
+	                                   { "height", { 1, 1, 1 } } };
+	map<string, vector<double>> weights = { { "height", { 1, 1, na } } };
+	map<string, vector<double>> res = { { "lai", { 1, 5, na } },
+	                                    { "height", { 10, 24, 30 } } };
+	Objective objective;
+	objective.init(obs, et, weights, 10);
+	vector<double> components;
+	double score = objective(res, &components);
+	Objective::Partial partial;
+	objective.start(partial);
+	double bound = objective.bound(partial, res, 3);
+	//lai: only day 1, (2 - 1) / 2 inside its missing bounds; height: day 2
+	//outside obs +/- 1, (20 - 24) / 20 penalized, over 2 days. The bound
+	//divides by the days lai could have been compared on, 1 and 3
+	double lai = 0.5;
+	double height = sqrt(0.2 * 0.2 * 10 / 2);
+	bool ok = is_na(na) and !is_na(1.) and !is_na(INFINITY) and
+	        is_inf(INFINITY) and is_inf(-INFINITY) and !is_inf(na) and !is_inf(numeric_limits<double>::max()) and
+	        fabs(components[0] - height) < 1e-12 and fabs(components[1] - lai) < 1e-12 and
+	        fabs(score - (lai + height)) < 1e-12 and
+	        fabs(bound - (sqrt(0.25 / 2) + height)) < 1e-12;
+	cout << "objective " << score << " (expected " << lai + height << "), bound "
+	     << bound << (ok ? ": ok\n" : ": FAILED\n");
+	return ok ? 0 : 1;
+}
+
+//InterceptionModel::absorbed against the hourly loop it replaced, over 10
+//years of days and 6 LAI: the same bits unless built with fast math, which
+//reorders the sums
+double interceptionLoop(const model::SolarDay &day, double kpd, double lai) {
+	double diffuse = 1 - std::exp(-(kpd * lai));
+	double sum = 0;
+	for (int i = 0; i < 24; ++i) {
+		double direct = day.kpb[i] != 0 ? 1 - std::exp(-(day.kpb[i] * lai)) : 0;
+		sum = sum + (day.diffuse[i] * diffuse + day.direct[i] * direct);
+	}
+	return sum;
+}
+
+int checkInterception() {
+	std::vector<ecomeristem::Climate> climates;
+	for (int i = 0; i < 3650; ++i)
+		climates.push_back(ecomeristem::Climate(20, 2 + 10 * fabs(sin(i * 0.37)), 4, 0, 0));
+	std::shared_ptr<const std::vector<ecomeristem::Climate>> meteo =
+	        std::make_shared<const std::vector<ecomeristem::Climate>>(climates);
+	double begin = 2457024;
+	model::SolarTable table(meteo, begin);
+#if defined(__FINITE_MATH_ONLY__) && __FINITE_MATH_ONLY__
+	double tolerance = 1e-12;
+#else
+	double tolerance = 0;
+#endif
+	int cases = 0, exact = 0;
+	double worst = 0;
+	for (int i = 0; i < 3650; ++i) {
+		for (double lai : { 0.001, 0.05, 0.3, 1.0, 2.5, 7.0 }) {
+			const model::SolarDay *day = table.find(begin + i);
+			double kpd = 0.5 + 0.1 * lai;
+			double expected = interceptionLoop(*day, kpd, lai);
+			double value = model::InterceptionModel::absorbed(*day, kpd, lai, 0);
+			worst = std::max(worst, fabs(value - expected) / fabs(expected));
+			exact += value == expected;
+			++cases;
+		}
+	}
+	bool ok = worst <= tolerance;
+	cout << "interception " << cases << " cases, " << exact << " exact, worst relative difference "
+	     << worst << (ok ? ": ok\n" : ": FAILED\n");
+	return ok ? 0 : 1;
+}
+
+//heap allocations of the simulator arena over repeated runs of folder:
+//only the first run may allocate
+int checkArena(const std::string &folder, int runs = 5) {
+	utils::ParametersReader reader;
+	ecomeristem::ModelParameters parameters;
+	reader.loadParametersFromFiles(folder, parameters);
+	parameters.resolve();
+	parameters.beginDate = parameters.get("BeginDate");
+	GlobalParameters globalParameters;
+	EcomeristemContext context(parameters.beginDate, parameters.get("EndDate"));
+	EcomeristemSimulator simulator(new PlantModel(), globalParameters);
+	unsigned long first = 0;
+	bool ok = true;
+	for (int i = 0; i < runs; ++i) {
+		simulator.init(parameters.beginDate, parameters);
+		simulator.run(context);
+		if (i == 0)
+			first = simulator.arena().allocations();
+		ok = ok && simulator.arena().allocations() == first;
+		cout << "run " << i + 1 << ": " << simulator.arena().allocations() << " allocations, "
+		     << simulator.arena().objects() << " objects\n";
+	}
+	cout << (ok ? "arena: ok\n" : "arena: FAILED\n");
+	return ok ? 0 : 1;
+}
+
+//results of folder with the culms computed on threads against one thread,
+//threaded first so that its culms build the first panicles and peduncles;
+//to run under -fsanitize=thread too
+map<string, vector<double>> culmRun(const std::string &folder, unsigned int threads) {
+	utils::ParametersReader reader;
+	ecomeristem::ModelParameters parameters;
+	reader.loadParametersFromFiles(folder, parameters);
+	parameters.resolve();
+	parameters.beginDate = parameters.get("BeginDate");
+	GlobalParameters globalParameters;
+	EcomeristemContext context(parameters.beginDate, parameters.get("EndDate"));
+	EcomeristemSimulator simulator(new PlantModel(), globalParameters);
+	simulator.model()->setCulmThreads(threads);
+	observer::PlantView view;
+	simulator.attachView("plant", &view);
+	simulator.init(parameters.beginDate, parameters);
+	simulator.run(context);
+	ResultParser parser;
+	return parser.resultsToMap(&simulator);
+}
+
+int checkCulmThreads(const std::string &folder, unsigned int threads = 4) {
+	map<string, vector<double>> threaded = culmRun(folder, threads);
+	map<string, vector<double>> single = culmRun(folder, 1);
+	bool same = threaded.size() == single.size();
+	for (auto token : single) {
+		const vector<double> & v = threaded[token.first];
+		same = same && v.size() == token.second.size();
+		for (size_t i = 0; same && i < v.size(); ++i)
+			same = v[i] == token.second[i] || (std::isnan(v[i]) && std::isnan(token.second[i]));
+	}
+	const vector<double> & tillers = single["tillernb_1"];
+	const vector<double> & panicles = single["paniclenb"];
+	double culms = tillers.empty() ? 0 : *max_element(tillers.begin(), tillers.end()) + 1;
+	double created = panicles.empty() ? 0 : *max_element(panicles.begin(), panicles.end());
+	cout << culms << " culms, " << created << " panicles, " << threads << " threads: "
+	     << (same ? "same results\n" : "results differ\n");
+	bool ok = same && culms > 1 && created > 0;
+	cout << (ok ? "culm threads: ok\n" : "culm threads: FAILED\n");
+	return ok ? 0 : 1;
+}
+
 int main(int argc, char *argv[]) {
+	if (argc > 2 && std::string(argv[1]) == "--bench-env")
+		return benchEnvironment(argv[2]);
+	if (argc > 1 && std::string(argv[1]) == "--check-objective")
+		return checkObjective();
+	if (argc > 1 && std::string(argv[1]) == "--check-interception")
+		return checkInterception();
+	if (argc > 2 && std::string(argv[1]) == "--check-arena")
+		return checkArena(argv[2]);
+	if (argc > 2 && std::string(argv[1]) == "--check-culm-threads")
+		return checkCulmThreads(argv[2], argc > 3 ? atoi(argv[3]) : 4);
+
 
 	std::string dirName = "D:\\Samples\\_Estimation\\G1";
 	ecomeristem::ModelParameters parameters;
@@ -3,6 +3,7 @@
 
 #include <ModelParameters.hpp>
 #include <utils/juliancalculator.h>
+#include <utils/environmentfile.h>
 #include <defines.hpp>
 
 using namespace ecomeristem;
@@ -10,6 +11,9 @@ using namespace std;
 
 #include <iostream>
 #include <fstream>
+#include <cstring>
+#include <functional>
+#include <sys/stat.h>
 
 template<typename Out>
 void split(const std::string &s, char delim, Out result) {
@@ -128,10 +132,98 @@ public:
         }
         parameters.set("EndDate", JulianCalculator::toJulianDay(date, JulianCalculator::DMY, '/'));
         varietyParams.close();
+        parameters.resolve();
 
 
     }
 
+    //binary environment file written by saveEnvironment; returns false,
+    //leaving parameters untouched, if path is not one
+    bool loadParametersFromEnvironment(const std::string &path, ModelParameters &parameters) {
+        MappedFile file(path);
+        EnvironmentHeader header;
+        if (file.size() < sizeof(header))
+            return false;
+        std::memcpy(&header, file.data(), sizeof(header));
+        //rows and parameters are checked one at a time: a corrupt header
+        //could make 5 * rows + parameters wrap around
+        uint64_t doubles = (file.size() - sizeof(header)) / sizeof(double);
+        if (std::memcmp(header.magic, ENVIRONMENT_MAGIC, sizeof(header.magic)) != 0 ||
+                header.rows > doubles / 5 || header.parameters > doubles - 5 * header.rows)
+            return false;
+
+        const double * columns = reinterpret_cast<const double *>(file.data() + sizeof(header));
+        const double * values = columns + 5 * header.rows;
+        const char * name = reinterpret_cast<const char *>(values + header.parameters);
+        const char * end = file.data() + file.size();
+        std::vector < std::pair < std::string, double > > params;
+        for (uint64_t i = 0; i < header.parameters; ++i) {
+            const char * last = static_cast<const char *>(std::memchr(name, '\0', end - name));
+            if (!last)
+                return false;
+            params.push_back(std::make_pair(std::string(name, last), values[i]));
+            name = last + 1;
+        }
+
+        for (const std::pair < std::string, double > &param : params)
+            parameters.set(param.first, param.second);
+        parameters.meteoValues.reserve(parameters.meteoValues.size() + header.rows);
+        for (uint64_t i = 0; i < header.rows; ++i)
+            parameters.meteoValues.push_back(
+                        Climate(columns[i], columns[header.rows + i],
+                                columns[2 * header.rows + i], columns[3 * header.rows + i],
+                                columns[4 * header.rows + i]));
+        parameters.beginDate = header.beginDate;
+        parameters.resolve();
+        return true;
+    }
+
+    //folder in the layout of loadParametersFromFiles or binary environment
+    //file; returns false if path is neither, a damaged file included
+    bool load(const std::string &path, ModelParameters &parameters) {
+        if (loadParametersFromEnvironment(path, parameters))
+            return true;
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0 || !(st.st_mode & S_IFDIR))
+            return false;
+        loadParametersFromFiles(path, parameters);
+        return true;
+    }
+
+    //writes the meteo and parameters as a binary environment file
+    bool saveEnvironment(const std::string &path, ModelParameters &parameters) {
+        std::map < std::string, double > * params = parameters.getRawParameters();
+        std::map < std::string, double >::const_iterator latitude = params->find("Latitude");
+        EnvironmentHeader header;
+        std::memcpy(header.magic, ENVIRONMENT_MAGIC, sizeof(header.magic));
+        header.rows = parameters.meteoValues.size();
+        header.parameters = params->size();
+        header.beginDate = parameters.beginDate;
+        header.latitude = latitude == params->end() ? nan("") : latitude->second;
+
+        std::vector < double > data;
+        data.reserve(5 * header.rows + header.parameters);
+        for (const Climate &c : parameters.meteoValues)
+            data.push_back(c.Temperature);
+        for (const Climate &c : parameters.meteoValues)
+            data.push_back(c.Par);
+        for (const Climate &c : parameters.meteoValues)
+            data.push_back(c.Etp);
+        for (const Climate &c : parameters.meteoValues)
+            data.push_back(c.Irrigation);
+        for (const Climate &c : parameters.meteoValues)
+            data.push_back(c.P);
+        for (auto const &param : *params)
+            data.push_back(param.second);
+
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(data.data()), data.size() * sizeof(double));
+        for (auto const &param : *params)
+            file.write(param.first.c_str(), param.first.size() + 1);
+        return static_cast<bool>(file);
+    }
+
 
 #ifdef UNSAFE_RUN
     std::istream& safeGetline(std::istream& is, std::string& t)
@@ -168,94 +260,72 @@ public:
     }
 
     map<string, vector<double>> loadCleanObsFromFile(const std::string &file_path, const SimpleView & view) {
-        std::ifstream vObsFile(file_path);
-        std::string line;
-        std::getline(vObsFile, line); //headers
-        vector<string> headers;
-        istringstream iss(line);
-        copy(istream_iterator<string>(iss),
-             istream_iterator<string>(),
-             back_inserter(headers));
-
-        map<string, vector<double> > obs;
-        for (string h: headers) {
-            string * s = new string(h);
-            transform(s->begin(), s->end(), s->begin(), ::tolower);
-            if (view._selectors.find(*s) != view._selectors.end() || *s == "day")
-                obs.insert ( std::pair<string,vector<double> >(*s, vector<double>()) );
-            delete s;
-        }
-
-        while (getline(vObsFile, line))
-        {
-            //std::cout << line << "\n";
-            //line.erase (line.begin(), line.end()-2);
-            vector<string> data = split(line, '\t');
-            for (int i = 0; i < data.size(); ++i) {
-                string s = data[i];
-                string * h = new string(headers[i]);
-                //std::cout << s << " " << s.size() << " " << data[i] << " " << data[i].size() << " " << *h << " " << headers[i] << "\n";
-                transform(h->begin(), h->end(), h->begin(), ::tolower);
-                if (view._selectors.find(*h) != view._selectors.end() || *h == "day") {
-                    char* p;
-                    double converted = strtod(s.c_str(), &p);
-                    if (*p) {
-                        //std::cout << "ADD NAN \n";
-                        obs[*h].push_back(nan(""));
-                    }
-                    else {
-                        //std::cout << converted << "\n";
-                        obs[*h].push_back(converted);
-                    }
-                }
-                delete h;
-            }
-        }
-        vObsFile.close();
-
-        return obs;
+        return readObs(file_path, [&view](const std::string &header) {
+            return view._selectors.find(header) != view._selectors.end() || header == "day";
+        });
     }
 #endif
 
     map<string, vector<double>> loadVObsFromFile(const std::string &file_path) {
-        std::ifstream vObsFile(file_path);
-        std::string line;
-        std::getline(vObsFile, line); //headers
-        vector<string> headers;
-        istringstream iss(line);
-        copy(istream_iterator<string>(iss),
-             istream_iterator<string>(),
-             back_inserter(headers));
+        return readObs(file_path, [](const std::string &) { return true; });
+    }
 
+    //columns of a tab separated obs file, in one pass over its content: the
+    //headers, lowercased, are matched once against keep, then each cell is
+    //converted in place. Cells that are not a whole number (NA, empty) and
+    //the missing cells of short rows are NaN; CRLF line ends are accepted.
+    map<string, vector<double>> readObs(const std::string &file_path,
+                                        const std::function<bool(const std::string &)> &keep) {
         map<string, vector<double> > obs;
-        for (string h: headers) {
-            string * s = new string(h);
-            transform(s->begin(), s->end(), s->begin(), ::tolower);
-            obs.insert ( std::pair<string,vector<double> >(*s, vector<double>()) );
-            delete s;
-        }
-
-        while (std::getline(vObsFile, line))
-        {
-            line.erase( std::remove(line.begin(), line.end(), '\r'), line.end() );
-            vector<string> data = split(line, '\t');
-            for (int i = 0; i < data.size(); ++i) {
-                string s = data[i];
-                string * h = new string(headers[i]);
-                transform(h->begin(), h->end(), h->begin(), ::tolower);
-                char* p;
-                double converted = strtod(s.c_str(), &p);
-                if (*p) {
-                    obs[*h].push_back(nan(""));
+        std::ifstream file(file_path, std::ios::binary | std::ios::ate);
+        std::string content(file ? static_cast<size_t>(file.tellg()) : 0, '\0');
+        file.seekg(0);
+        file.read(&content[0], content.size());
+        const char * p = content.c_str();
+        const char * end = p + content.size();
+
+        //the column filled by each cell of a row, if any
+        std::vector<vector<double> *> columns;
+        size_t rows = std::count(content.begin(), content.end(), '\n');
+        while (p < end) {
+            const char * next = static_cast<const char *>(std::memchr(p, '\n', end - p));
+            next = next ? next + 1 : end;
+            const char * last = next;
+            while (last > p && (last[-1] == '\n' || last[-1] == '\r'))
+                --last;
+            if (p == content.c_str()) {
+                istringstream iss(std::string(p, last));
+                for (istream_iterator<string> it(iss); it != istream_iterator<string>(); ++it) {
+                    string h = *it;
+                    transform(h.begin(), h.end(), h.begin(), ::tolower);
+                    vector<double> * column = nullptr;
+                    if (keep(h) && obs.find(h) == obs.end()) {
+                        column = &obs[h];
+                        column->reserve(rows);
+                    }
+                    columns.push_back(column);
                 }
-                else {
-                    obs[*h].push_back(converted);
+            } else if (last > p) {
+                size_t i = 0;
+                for (const char * cell = p; ; ++i) {
+                    const char * tab = static_cast<const char *>(std::memchr(cell, '\t', last - cell));
+                    if (!tab)
+                        tab = last;
+                    if (i < columns.size() && columns[i]) {
+                        char * parsed;
+                        double converted = strtod(cell, &parsed);
+                        columns[i]->push_back(cell < tab && parsed == tab ? converted : nan(""));
+                    }
+                    if (tab == last)
+                        break;
+                    cell = tab + 1;
                 }
-                delete h;
+                for (++i; i < columns.size(); ++i)
+                    if (columns[i])
+                        columns[i]->push_back(nan(""));
             }
+            p = next;
         }
-        vObsFile.close();
-
         return obs;
     }
 
@@ -0,0 +1,127 @@
+#ifndef DIFFERENTIALEVOLUTION_H
+#define DIFFERENTIALEVOLUTION_H
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <functional>
+#include <utils/random.h>
+
+using namespace std;
+
+//Differential evolution minimizer with DEoptim's DE/local-to-best/1/bin
+//strategy (strategy 2) and stopping rules. A generation is drawn as a whole
+//before being evaluated: a seed gives the same run whatever the evaluation
+//order.
+class DifferentialEvolution
+{
+public:
+    struct Control {
+        unsigned int NP;       //population size, 0 for 10 per parameter
+        unsigned int itermax;
+        double F;
+        double CR;
+        double reltol;
+        unsigned int steptol;  //0 for itermax
+        double VTR;
+        unsigned long seed;
+
+        Control() : NP(0), itermax(200), F(0.8), CR(0.5),
+            reltol(std::sqrt(std::numeric_limits<double>::epsilon())),
+            steptol(0), VTR(-std::numeric_limits<double>::infinity()), seed(0) {}
+    };
+
+    struct Result {
+        vector<double> bestmem;
+        double bestval;
+        unsigned int iter;
+        unsigned long nfeval;
+    };
+
+    //fills values with the scores of the candidates; a candidate may be
+    //abandoned once its score is known to be above its threshold, its value
+    //is then any number above the threshold
+    typedef std::function < void(const vector<vector<double>>& candidates,
+                                 const vector<double>& thresholds,
+                                 vector<double>& values) > Evaluate;
+
+    Result minimize(const vector<double>& lower, const vector<double>& upper,
+                    const Control& control, const Evaluate& evaluate)
+    {
+        size_t D = lower.size();
+        size_t NP = control.NP > 0 ? control.NP : 10 * D;
+        unsigned int steptol = control.steptol > 0 ? control.steptol : control.itermax;
+        _random.seed(control.seed);
+
+        vector<vector<double>> population(NP, vector<double>(D));
+        for (size_t i = 0; i < NP; ++i)
+            for (size_t j = 0; j < D; ++j)
+                population[i][j] = lower[j] + uniform() * (upper[j] - lower[j]);
+        vector<double> values(NP);
+        evaluate(population, vector<double>(NP, std::numeric_limits<double>::infinity()), values);
+
+        Result result;
+        result.nfeval = NP;
+        result.iter = 0;
+        size_t best = 0;
+        for (size_t i = 1; i < NP; ++i)
+            if (values[i] < values[best])
+                best = i;
+
+        vector<vector<double>> trials(NP, vector<double>(D));
+        vector<double> trial_values(NP);
+        unsigned int stalled = 0;
+        while (result.iter < control.itermax and values[best] > control.VTR and stalled < steptol) {
+            //each trial moves its target toward the best member of the previous
+            //generation plus a scaled difference of two other members
+            const vector<double> bestit = population[best];
+            for (size_t i = 0; i < NP; ++i) {
+                size_t r1, r2;
+                do { r1 = index(NP); } while (r1 == i and NP > 1);
+                do { r2 = index(NP); } while ((r2 == i or r2 == r1) and NP > 2);
+                trials[i] = population[i];
+                size_t j = index(D);
+                for (size_t k = 0; k < D; ++k) {
+                    if (k == 0 or uniform() < control.CR) {
+                        trials[i][j] += control.F * (bestit[j] - trials[i][j]) +
+                                control.F * (population[r1][j] - population[r2][j]);
+                    }
+                    j = (j + 1) % D;
+                }
+                //out of bounds values are drawn again within the bounds
+                for (size_t m = 0; m < D; ++m)
+                    if (trials[i][m] < lower[m] or trials[i][m] > upper[m])
+                        trials[i][m] = lower[m] + uniform() * (upper[m] - lower[m]);
+            }
+
+            //a trial replaces its target when it is not worse
+            evaluate(trials, values, trial_values);
+            result.nfeval += NP;
+            double previous = values[best];
+            for (size_t i = 0; i < NP; ++i) {
+                if (trial_values[i] <= values[i]) {
+                    population[i].swap(trials[i]);
+                    values[i] = trial_values[i];
+                }
+                if (values[i] < values[best])
+                    best = i;
+            }
+            ++result.iter;
+            if (previous - values[best] < control.reltol * (std::fabs(previous) + control.reltol))
+                ++stalled;
+            else
+                stalled = 0;
+        }
+        result.bestmem = population[best];
+        result.bestval = values[best];
+        return result;
+    }
+
+private:
+    Random _random;
+
+    double uniform() { return _random.uniform(); }
+    size_t index(size_t n) { return _random.index(n); }
+};
+
+#endif // DIFFERENTIALEVOLUTION_H
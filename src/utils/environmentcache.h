@@ -0,0 +1,102 @@
+#ifndef ENVIRONMENTCACHE_H
+#define ENVIRONMENTCACHE_H
+
+#include <utils/ParametersReader.hpp>
+#include <sys/stat.h>
+#include <memory>
+#include <mutex>
+
+//Process-wide cache of the environments loaded by ParametersReader::load,
+//keyed by path and checked against the modification time and size of the
+//files read. Environments are immutable and their meteo is shared: copies
+//of an environment's parameters don't copy the meteo.
+namespace utils {
+
+class EnvironmentCache {
+public:
+    typedef std::shared_ptr < const ModelParameters > Environment;
+
+    static EnvironmentCache &instance() {
+        static EnvironmentCache cache;
+        return cache;
+    }
+
+    //path is a folder in the text layout or a binary environment file; it
+    //is loaded again when one of its files changed since the last call.
+    //Null if path is neither
+    Environment get(const std::string &path) {
+        std::vector < double > stamps = stamp(path);
+        std::lock_guard < std::mutex > lock(_mutex);
+        Entry &entry = _entries[path];
+        if (!entry.environment || entry.stamps != stamps) {
+            std::shared_ptr < ModelParameters > parameters = std::make_shared < ModelParameters >();
+            if (!ParametersReader().load(path, *parameters)) {
+                _entries.erase(path);
+                return nullptr;
+            }
+            parameters->shareMeteo();
+            entry.stamps = stamps;
+            entry.environment = parameters;
+        }
+        return entry.environment;
+    }
+
+    //environments in use stay alive until released by their users
+    void clear() {
+        std::lock_guard < std::mutex > lock(_mutex);
+        _entries.clear();
+    }
+
+    void clear(const std::string &path) {
+        std::lock_guard < std::mutex > lock(_mutex);
+        _entries.erase(path);
+    }
+
+private:
+    struct Entry {
+        std::vector < double > stamps;
+        Environment environment;
+    };
+
+    //modification time, to the nanosecond where the system has it, and size
+    //of the files load reads, -1 if missing: a file rewritten within the
+    //same second with the same size is still seen as changed
+    static std::vector < double > stamp(const std::string &path) {
+        std::vector < std::string > files;
+        struct stat st;
+        if (stat(path.c_str(), &st) == 0 && !(st.st_mode & S_IFDIR)) {
+            files.push_back(path);
+        } else {
+            const char * names[6] = { "ECOMERISTEM_parameters.txt", "meteo_T.txt",
+                                      "meteo_PAR.txt", "meteo_ETP.txt",
+                                      "meteo_irrig.txt", "meteo_P.txt" };
+            for (const char * name : names)
+                files.push_back(path + "/" + name);
+        }
+        std::vector < double > stamps;
+        for (const std::string &file : files) {
+            bool found = stat(file.c_str(), &st) == 0;
+            stamps.push_back(found ? static_cast < double >(st.st_mtime) : -1);
+            stamps.push_back(found ? nanoseconds(st) : -1);
+            stamps.push_back(found ? static_cast < double >(st.st_size) : -1);
+        }
+        return stamps;
+    }
+
+    static double nanoseconds(const struct stat &st) {
+#if defined(__APPLE__)
+        return static_cast < double >(st.st_mtimespec.tv_nsec);
+#elif defined(_WIN32)
+        return 0;
+#else
+        return static_cast < double >(st.st_mtim.tv_nsec);
+#endif
+    }
+
+    std::mutex _mutex;
+    std::map < std::string, Entry > _entries;
+};
+
+} // namespace utils
+
+#endif // ENVIRONMENTCACHE_H
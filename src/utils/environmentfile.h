@@ -0,0 +1,87 @@
+#ifndef ENVIRONMENTFILE_H
+#define ENVIRONMENTFILE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+//Binary environment file: an EnvironmentHeader, then the five meteo columns
+//of rows doubles each (Temperature, Par, Etp, Irrigation, P), then the
+//values of the parameters followed by their NUL terminated names. Numbers
+//are stored as native doubles, a file is read back on machines with the
+//byte order it was written with.
+namespace utils {
+
+static const char ENVIRONMENT_MAGIC[8] = "ECOENV1";
+
+struct EnvironmentHeader {
+    char magic[8];
+    uint64_t rows;
+    uint64_t parameters;
+    double beginDate;
+    double latitude; //NaN when the parameters don't give it
+};
+
+//read-only view of a whole regular file, mapped in memory where mmap is
+//available; empty when the file can't be read
+class MappedFile {
+public:
+    MappedFile(const std::string &path) : _data(nullptr), _size(0) {
+#ifdef _WIN32
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (file) {
+            _buffer.resize(static_cast<size_t>(file.tellg()));
+            file.seekg(0);
+            if (file.read(_buffer.data(), _buffer.size())) {
+                _data = _buffer.data();
+                _size = _buffer.size();
+            }
+        }
+#else
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            void * data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED) {
+                _data = static_cast<const char *>(data);
+                _size = st.st_size;
+            }
+        }
+        close(fd);
+#endif
+    }
+
+    ~MappedFile() {
+#ifndef _WIN32
+        if (_data)
+            munmap(const_cast<char *>(_data), _size);
+#endif
+    }
+
+    const char * data() const { return _data; }
+    size_t size() const { return _size; }
+
+private:
+    MappedFile(const MappedFile &);
+    MappedFile &operator=(const MappedFile &);
+
+    const char * _data;
+    size_t _size;
+#ifdef _WIN32
+    std::vector<char> _buffer;
+#endif
+};
+
+} // namespace utils
+
+#endif // ENVIRONMENTFILE_H
@@ -0,0 +1,152 @@
+#ifndef OBJECTIVE_H
+#define OBJECTIVE_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <artis_lite/simplefloat.h>
+
+using namespace std;
+
+//Calibration score of a simulation against observations, as computed by the
+//estimation scripts: for each variable, the root of the mean weighted squared
+//relative error, multiplied by the penalty on the days the simulated value
+//falls outside obs +/- obsET; the score is the sum over the variables.
+//Results are expected as returned by runOptim, one value per obs row.
+class Objective
+{
+    struct Target {
+        string name;
+        vector<double> obs;
+        vector<double> lower;
+        vector<double> upper;
+        vector<double> weights;
+        int rows; //days that can be compared at most
+    };
+
+    vector<Target> _targets;
+    double _penalty;
+
+    //error of the simulated value on day i, NaN if it can't be compared
+    double error(const Target& target, size_t i, double res) const
+    {
+        if (is_na(res) or is_na(target.obs[i]) or is_na(target.weights[i]))
+            return nan("");
+        bool inside = (is_na(target.lower[i]) or res >= target.lower[i]) and
+                (is_na(target.upper[i]) or res <= target.upper[i]);
+        double factor = inside ? 1 : _penalty;
+        double rel = (target.obs[i] - res) / target.obs[i];
+        return rel * rel * factor * target.weights[i];
+    }
+
+public:
+    //error sums of a run in progress, see bound()
+    struct Partial {
+        vector<double> sums;
+        size_t rows;
+    };
+
+    Objective() : _penalty(1) {}
+
+    //days without obsET are not penalized, as with data.table::between
+    //on NA bounds; a variable missing from weights has a weight of 1
+    void init(const map<string, vector<double>>& obs,
+              const map<string, vector<double>>& obsET,
+              const map<string, vector<double>>& weights,
+              double penalty, const string& dayColName = "day")
+    {
+        _targets.clear();
+        //R multiplies by the penalty then replaces the zeros by 1
+        _penalty = penalty == 0 ? 1 : penalty;
+        for (auto const &token : obs) {
+            if (token.first == dayColName)
+                continue;
+            Target target;
+            target.name = token.first;
+            target.obs = token.second;
+            target.rows = 0;
+            auto et = obsET.find(token.first);
+            auto w = weights.find(token.first);
+            for (size_t i = 0; i < token.second.size(); ++i) {
+                double e = et == obsET.end() ? nan("") :
+                        (i < et->second.size() ? et->second[i] : nan(""));
+                target.lower.push_back(token.second[i] - e);
+                target.upper.push_back(token.second[i] + e);
+                target.weights.push_back(w == weights.end() ? 1 :
+                        (i < w->second.size() ? w->second[i] : nan("")));
+                if (!is_na(target.obs[i]) and !is_na(target.weights.back()))
+                    ++target.rows;
+            }
+            _targets.push_back(target);
+        }
+    }
+
+    bool empty() const { return _targets.empty(); }
+    size_t size() const { return _targets.size(); }
+    const string& name(size_t k) const { return _targets[k].name; }
+
+    //components, if given, receives the score of each variable (NaN when
+    //none of its days could be compared)
+    double operator()(const map<string, vector<double>>& results,
+                      vector<double> * components = nullptr) const
+    {
+        double score = 0;
+        if (components)
+            components->assign(_targets.size(), nan(""));
+        for (size_t k = 0; k < _targets.size(); ++k) {
+            const Target& target = _targets[k];
+            auto it = results.find(target.name);
+            if (it == results.end())
+                continue;
+            const vector<double>& res = it->second;
+            double sum = 0;
+            int n = 0;
+            for (size_t i = 0; i < target.obs.size() and i < res.size(); ++i) {
+                double d = error(target, i, res[i]);
+                if (is_na(d))
+                    continue;
+                sum += d;
+                ++n;
+            }
+            if (n > 0) {
+                double c = sqrt(sum / n);
+                if (components)
+                    (*components)[k] = c;
+                if (!is_na(c))
+                    score += c;
+            }
+        }
+        return score;
+    }
+
+    void start(Partial& partial) const
+    {
+        partial.sums.assign(_targets.size(), 0);
+        partial.rows = 0;
+    }
+
+    //adds the days compared since the last call, up to rows, and returns a
+    //lower bound of the final score: error sums only grow and each mean
+    //is taken over at most target.rows days
+    double bound(Partial& partial, const map<string, vector<double>>& results, size_t rows) const
+    {
+        double score = 0;
+        for (size_t k = 0; k < _targets.size(); ++k) {
+            const Target& target = _targets[k];
+            auto it = results.find(target.name);
+            if (it == results.end() or target.rows == 0)
+                continue;
+            for (size_t i = partial.rows; i < rows and i < target.obs.size() and i < it->second.size(); ++i) {
+                double d = error(target, i, it->second[i]);
+                if (!is_na(d))
+                    partial.sums[k] += d;
+            }
+            score += sqrt(partial.sums[k] / target.rows);
+        }
+        partial.rows = rows;
+        return score;
+    }
+};
+
+#endif // OBJECTIVE_H
@@ -0,0 +1,24 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <random>
+
+//Seeded uniform numbers, converted to doubles by hand rather than through
+//std distributions, which differ between standard libraries: a seed gives
+//the same numbers on every platform.
+class Random
+{
+public:
+    Random(unsigned long seed = 0) : _generator(seed) {}
+
+    void seed(unsigned long seed) { _generator.seed(seed); }
+    //in [0, 1)
+    double uniform() { return (_generator() >> 11) * (1.0 / 9007199254740992.0); }
+    //in [0, n)
+    size_t index(size_t n) { return static_cast<size_t>(uniform() * n); }
+
+private:
+    std::mt19937_64 _generator;
+};
+
+#endif // RANDOM_H
@@ -19,6 +19,13 @@ public:
         const Observer& observer = simulator->observer();
         const Observer::Views& views = observer.views();
         Observer::Views::const_iterator it = views.begin();
+#ifdef UNSAFE_RUN
+        const View * view = it->second;
+        for (size_t k = 0; k < view->columns(); ++k) {
+            const double * c = view->column(k);
+            result.insert(std::make_pair(view->name(k), vector<double>(c, c + view->size())));
+        }
+#else
         View::Values values = it->second->values();
         double begin = it->second->begin();
         double end = it->second->end();
@@ -41,10 +48,6 @@ public:
                 }
 
                 if (itp != itv->second.end()) {
-#ifdef UNSAFE_RUN
-                  double converted = itp->second;
-                  result[s].push_back(converted);
-#else
                     string c = itp->second;
                     char* p;
                     double converted = strtod(c.c_str(), &p);
@@ -53,12 +56,12 @@ public:
                     } else {
                         result[s].push_back(converted);
                     }
-#endif
                 } else {
                     result[s].push_back(nan(""));
                 }
             }
         }
+#endif
         return result;
     }
 
@@ -0,0 +1,216 @@
+#ifndef SENSITIVITY_H
+#define SENSITIVITY_H
+
+#include <vector>
+#include <cmath>
+#include <numeric>
+#include <algorithm>
+#include <utils/random.h>
+
+using namespace std;
+
+//Global sensitivity designs and indices, as defined by the R sensitivity
+//package: morris (oat design), fast99 and Saltelli's scheme for Sobol
+//indices. Designs are rows of factor values within [lower, upper]; indices
+//are computed from the output of each row, in the same order.
+namespace sensitivity {
+
+typedef vector < vector < double > > Design;
+
+//r trajectories of k + 1 points on a grid of levels values per factor, each
+//point moving one factor by jump levels from the previous one
+inline Design morris(const vector<double>& lower, const vector<double>& upper,
+                     unsigned int r, unsigned int levels, unsigned int jump,
+                     unsigned long seed)
+{
+    size_t k = lower.size();
+    double delta = static_cast<double>(jump) / (levels - 1);
+    Random random(seed);
+    Design X;
+    for (unsigned int t = 0; t < r; ++t) {
+        vector<size_t> order(k);
+        std::iota(order.begin(), order.end(), 0);
+        for (size_t i = k; i > 1; --i)
+            std::swap(order[i - 1], order[random.index(i)]);
+        //the base point leaves room for the move of each factor
+        vector<double> x(k), direction(k);
+        for (size_t i = 0; i < k; ++i) {
+            direction[i] = random.uniform() < 0.5 ? 1 : -1;
+            unsigned int level = random.index(levels - jump);
+            x[i] = (direction[i] > 0 ? level : level + jump) / static_cast<double>(levels - 1);
+        }
+        for (size_t m = 0; m <= k; ++m) {
+            if (m > 0)
+                x[order[m - 1]] += direction[order[m - 1]] * delta;
+            vector<double> row(k);
+            for (size_t i = 0; i < k; ++i)
+                row[i] = lower[i] + x[i] * (upper[i] - lower[i]);
+            X.push_back(row);
+        }
+    }
+    return X;
+}
+
+//mean, mean of the absolute values and standard deviation of the
+//elementary effects of each factor, in factor units
+inline void morris_indices(const Design& X, const vector<double>& y,
+                           vector<double>& mu, vector<double>& mu_star,
+                           vector<double>& sigma)
+{
+    size_t k = X[0].size();
+    vector < vector < double > > effects(k);
+    for (size_t start = 0; start + k < X.size(); start += k + 1) {
+        for (size_t m = start + 1; m <= start + k; ++m) {
+            for (size_t i = 0; i < k; ++i) {
+                double dx = X[m][i] - X[m - 1][i];
+                if (dx != 0)
+                    effects[i].push_back((y[m] - y[m - 1]) / dx);
+            }
+        }
+    }
+    mu.assign(k, 0);
+    mu_star.assign(k, 0);
+    sigma.assign(k, 0);
+    for (size_t i = 0; i < k; ++i) {
+        size_t n = effects[i].size();
+        for (double e : effects[i]) {
+            mu[i] += e / n;
+            mu_star[i] += std::fabs(e) / n;
+        }
+        for (double e : effects[i])
+            sigma[i] += (e - mu[i]) * (e - mu[i]);
+        sigma[i] = n > 1 ? std::sqrt(sigma[i] / (n - 1)) : nan("");
+    }
+}
+
+//fast99 frequencies: omega[0] for the studied factor, the others for the
+//remaining ones in order
+inline vector<unsigned int> fast_omega(size_t k, unsigned int n, unsigned int M)
+{
+    vector<unsigned int> omega(k);
+    omega[0] = (n - 1) / (2 * M);
+    unsigned int m = omega[0] / (2 * M);
+    for (size_t i = 1; i < k; ++i) {
+        if (m >= k - 1)
+            omega[i] = k > 2 ? static_cast<unsigned int>(std::floor(1 + (m - 1) * (i - 1) / static_cast<double>(k - 2))) : 1;
+        else
+            omega[i] = (i - 1) % m + 1;
+    }
+    return omega;
+}
+
+//k blocks of n points, block i exploring factor i at the highest frequency
+inline Design fast(const vector<double>& lower, const vector<double>& upper,
+                   unsigned int n, unsigned int M)
+{
+    size_t k = lower.size();
+    vector<unsigned int> omega = fast_omega(k, n, M);
+    Design X(k * n, vector<double>(k));
+    for (size_t i = 0; i < k; ++i) {
+        for (size_t j = 0; j < k; ++j) {
+            unsigned int w = j == i ? omega[0] : omega[j < i ? j + 1 : j];
+            for (unsigned int l = 0; l < n; ++l) {
+                double s = 2 * M_PI / n * l;
+                double g = 0.5 + std::asin(std::sin(w * s)) / M_PI;
+                X[i * n + l][j] = lower[j] + g * (upper[j] - lower[j]);
+            }
+        }
+    }
+    return X;
+}
+
+//first order and total indices from the spectrum of each block
+inline void fast_indices(size_t k, const vector<double>& y, unsigned int n, unsigned int M,
+                         vector<double>& first, vector<double>& total)
+{
+    vector<unsigned int> omega = fast_omega(k, n, M);
+    vector<double> c(n), s(n);
+    for (unsigned int l = 0; l < n; ++l) {
+        c[l] = std::cos(2 * M_PI * l / n);
+        s[l] = std::sin(2 * M_PI * l / n);
+    }
+    first.assign(k, 0);
+    total.assign(k, 0);
+    for (size_t i = 0; i < k; ++i) {
+        const double * b = y.data() + i * n;
+        //squared modulus of the discrete Fourier transform at q
+        auto spectrum = [&](unsigned long q) {
+            double re = 0, im = 0;
+            for (unsigned int l = 0; l < n; ++l) {
+                unsigned long a = (q * l) % n;
+                re += b[l] * c[a];
+                im -= b[l] * s[a];
+            }
+            return re * re + im * im;
+        };
+        //V is twice the sum of the spectrum over 1..n/2-1, by Parseval
+        double sum = 0, sum2 = 0;
+        for (unsigned int l = 0; l < n; ++l) {
+            sum += b[l];
+            sum2 += b[l] * b[l];
+        }
+        double V = n * sum2 - sum * sum;
+        if (n % 2 == 0)
+            V -= spectrum(n / 2);
+        else
+            V -= 2 * spectrum((n - 1) / 2);
+        double D1 = 0, Dt = 0;
+        for (unsigned int p = 1; p <= M; ++p)
+            D1 += 2 * spectrum(p * omega[0]);
+        for (unsigned int q = 1; q <= omega[0] / 2; ++q)
+            Dt += 2 * spectrum(q);
+        first[i] = D1 / V;
+        total[i] = 1 - Dt / V;
+    }
+}
+
+//Saltelli's scheme: two random matrices A and B of N rows, then for each
+//factor i, A with the column i of B
+inline Design sobol(const vector<double>& lower, const vector<double>& upper,
+                    unsigned int N, unsigned long seed)
+{
+    size_t k = lower.size();
+    Random random(seed);
+    Design A(N, vector<double>(k)), B(N, vector<double>(k));
+    for (Design * M : { &A, &B })
+        for (unsigned int l = 0; l < N; ++l)
+            for (size_t j = 0; j < k; ++j)
+                (*M)[l][j] = lower[j] + random.uniform() * (upper[j] - lower[j]);
+    Design X(A);
+    X.insert(X.end(), B.begin(), B.end());
+    for (size_t i = 0; i < k; ++i) {
+        for (unsigned int l = 0; l < N; ++l) {
+            X.push_back(A[l]);
+            X.back()[i] = B[l][i];
+        }
+    }
+    return X;
+}
+
+//first order (Saltelli 2010) and total (Jansen) indices
+inline void sobol_indices(size_t k, const vector<double>& y, unsigned int N,
+                          vector<double>& first, vector<double>& total)
+{
+    const double * yA = y.data();
+    const double * yB = y.data() + N;
+    double mean = 0, V = 0;
+    for (unsigned int l = 0; l < 2 * N; ++l)
+        mean += y[l] / (2 * N);
+    for (unsigned int l = 0; l < 2 * N; ++l)
+        V += (y[l] - mean) * (y[l] - mean) / (2 * N - 1);
+    first.assign(k, 0);
+    total.assign(k, 0);
+    for (size_t i = 0; i < k; ++i) {
+        const double * yAB = y.data() + (2 + i) * N;
+        for (unsigned int l = 0; l < N; ++l) {
+            first[i] += yB[l] * (yAB[l] - yA[l]) / N;
+            total[i] += (yA[l] - yAB[l]) * (yA[l] - yAB[l]) / (2 * N);
+        }
+        first[i] /= V;
+        total[i] /= V;
+    }
+}
+
+}
+
+#endif // SENSITIVITY_H